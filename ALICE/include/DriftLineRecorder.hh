@@ -0,0 +1,50 @@
+/*
+ * DriftLineRecorder.hh
+ *
+ * Compact drift lines for display and output. A drift line is first
+ * simplified with the Douglas-Peucker algorithm, which keeps the points that
+ * deviate more than a tolerance from the polyline of the points kept so far,
+ * so straight stretches cost two points and the bends near the wires keep
+ * their shape. Recorded lines go to the DriftLines ntuple as 16-bit position
+ * offsets from the first point, scaled per line, and delta-coded 16-bit
+ * times:
+ *   x_i = X0 + DX_i*Scale,   t_i = T0 + TimeScale*(DT_0 + ... + DT_i)
+ */
+
+#ifndef DRIFTLINERECORDER_H_
+#define DRIFTLINERECORDER_H_
+
+#include "globals.hh"
+
+#include <vector>
+
+class DriftLineRecorder {
+ public:
+  struct Point {
+    double x, y, z;  // cm
+    double t;        // ns
+  };
+
+  // One recorder per thread
+  static DriftLineRecorder* Instance();
+
+  // Points of line kept within tolerance [cm], end points always kept
+  static void Simplify(const std::vector<Point>& line, double tolerance, std::vector<Point>& simplified);
+
+  // Quantise a simplified line and fill one row of the DriftLines ntuple
+  void Record(const std::vector<Point>& line);
+
+  inline std::vector<int>& GetDX() { return fDX; };
+  inline std::vector<int>& GetDY() { return fDY; };
+  inline std::vector<int>& GetDZ() { return fDZ; };
+  inline std::vector<int>& GetDT() { return fDT; };
+
+ private:
+  DriftLineRecorder() : fEvent(-1), fLine(0) {}
+
+  std::vector<int> fDX, fDY, fDZ, fDT;  // row buffers of the vector columns
+  G4int fEvent;
+  G4int fLine;
+};
+
+#endif /* DRIFTLINERECORDER_H_ */
@@ -0,0 +1,20 @@
+/*
+ * GarfieldRandom.hh
+ *
+ * Per-thread random numbers for Garfield++. Heed and the drift classes draw
+ * every random number from the single global Garfield::randomEngine. A TRandom
+ * that forwards each draw to a TRandom3 owned by the calling thread is
+ * installed there before main, so the worker threads no longer share one
+ * generator state and Heed transport needs no lock.
+ */
+
+#ifndef GARFIELDRANDOM_H_
+#define GARFIELDRANDOM_H_
+
+namespace GarfieldRandom {
+  // Seed the generator of this thread from its Geant4 engine, only the first
+  // call of a thread has an effect
+  void InitialiseThread();
+}
+
+#endif /* GARFIELDRANDOM_H_ */
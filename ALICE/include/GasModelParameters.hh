@@ -59,6 +59,32 @@ class GasModelParameters{
     inline bool GetVisualizeField(){return fVisualizeField;};
     inline void SetDriftRKF(bool b){driftRKF=b;};
     inline bool GetDriftRKF(){return driftRKF;};
+    //Runge-Kutta drift in the bulk, handed to AvalancheMC or microscopic tracking near the anode wires
+    inline void SetDriftHybrid(bool b){driftHybrid=b;};
+    inline bool GetDriftHybrid(){return driftHybrid;};
+    inline void SetHybridRadius(G4double r){hybridRadius=r;};
+    inline double GetHybridRadius(){return hybridRadius;};
+    //Simplified drift lines written to the DriftLines ntuple
+    inline void SetRecordDriftLines(bool b){recordDriftLines=b;};
+    inline bool GetRecordDriftLines(){return recordDriftLines;};
+    inline void SetDriftLineTolerance(G4double d){driftLineTolerance=d;};
+    inline double GetDriftLineTolerance(){return driftLineTolerance;};
+    //Signals from precomputed wire responses instead of the Garfield signal calculation
+    inline void SetFastSignal(bool b){fastSignal=b;};
+    inline bool GetFastSignal(){return fastSignal;};
+    inline void SetSignalGain(G4double g){signalGain=g;};
+    inline double GetSignalGain(){return signalGain;};
+    inline void SetSignalBinWidth(G4double w){signalBinWidth=w;};
+    inline double GetSignalBinWidth(){return signalBinWidth;};
+    inline void SetSignalBins(G4int n){signalBins=n;};
+    inline int GetSignalBins(){return signalBins;};
+    inline void SetSignalAngles(G4int n){signalAngles=n;};
+    inline int GetSignalAngles(){return signalAngles;};
+    //Library of Heed tracks sampled by HeedNewTrack instead of running Heed per primary
+    inline void SetClusterLibrary(G4String s){clusterLibrary=s;};
+    inline G4String GetClusterLibrary(){return clusterLibrary;};
+    inline void SetClusterLibraryTracks(G4int n){clusterLibraryTracks=n;};
+    inline int GetClusterLibraryTracks(){return clusterLibraryTracks;};
     
     inline MapParticlesEnergy GetParticleNamesHeedNewTrack(){return fMapParticlesEnergyHeedNewTrack;};
     inline MapParticlesEnergy GetParticleNamesHeedDeltaElectron(){return fMapParticlesEnergyHeedDeltaElectron;};
@@ -79,6 +105,19 @@ class GasModelParameters{
     bool fVisualizeSignal;
     bool fVisualizeField;
     bool driftRKF;
+    bool fastSignal;
+    bool driftHybrid;
+    double hybridRadius; // cm
+    bool recordDriftLines;
+    double driftLineTolerance; // cm
+    
+    double signalGain;
+    double signalBinWidth; // ns
+    int signalBins;
+    int signalAngles;
+    
+    G4String clusterLibrary;
+    int clusterLibraryTracks;
     
     double vPlaneHV;
     double vPlaneLow;
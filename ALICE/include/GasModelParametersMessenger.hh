@@ -49,6 +49,17 @@ class GasModelParametersMessenger : public G4UImessenger {
   G4UIcmdWithABool* visualizeSignalsCmd;
   G4UIcmdWithABool* visualizeFieldCmd;
   G4UIcmdWithABool* driftRKFCmd;
+  G4UIcmdWithABool* driftHybridCmd;
+  G4UIcmdWithADouble* hybridRadiusCmd;
+  G4UIcmdWithABool* recordDriftLinesCmd;
+  G4UIcmdWithADouble* driftLineToleranceCmd;
+  G4UIcmdWithABool* fastSignalCmd;
+  G4UIcmdWithADouble* signalGainCmd;
+  G4UIcmdWithADouble* signalBinWidthCmd;
+  G4UIcmdWithAnInteger* signalBinsCmd;
+  G4UIcmdWithAnInteger* signalAnglesCmd;
+  G4UIcmdWithAString* clusterLibraryCmd;
+  G4UIcmdWithAnInteger* clusterLibraryTracksCmd;
   G4UIcmdWithADouble* voltagePlaneHVCmd;
   G4UIcmdWithADouble* voltagePlaneLowCmd;
   G4UIcmdWithADouble* voltageAnodeWiresCmd;
@@ -0,0 +1,69 @@
+/*
+ * HeedClusterLibrary.hh
+ *
+ * Library of Heed tracks for beams of a fixed species and energy. Every
+ * entry holds many tracks of one (particle, energy) transported along a
+ * straight path, with the clusters stored in the frame of the track: distance
+ * along the path, transverse offsets, energy and the electrons relative to the
+ * cluster. HeedNewTrackModel samples a segment of a stored track instead of
+ * running Heed for every primary. Entries are generated on first use and
+ * appended to the library file, so later runs only read them. New entries are
+ * made at the centre of energy bins 2*kEnergyTolerance wide, and at most
+ * kMaxEntries are kept per file; beyond that a particle without an entry is
+ * left to Heed.
+ *
+ * File layout: "HEEDCLU1", then per entry
+ *   int32 nameLength, char name[nameLength], double energy_eV, double length_cm,
+ *   int32 nTracks, per track int32 nClusters, per cluster
+ *   float s, u, v, energy_eV, int32 nElectrons, per electron float ds, du, dv, dt
+ */
+
+#ifndef HEEDCLUSTERLIBRARY_H_
+#define HEEDCLUSTERLIBRARY_H_
+
+#include "globals.hh"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+class HeedClusterLibrary {
+ public:
+  struct Electron {
+    float ds, du, dv, dt;  // cm, ns relative to the cluster
+  };
+  struct Cluster {
+    float s, u, v;  // cm along and across the track
+    float energy;   // eV
+    std::vector<Electron> electrons;
+  };
+  typedef std::vector<Cluster> Track;
+  struct Entry {
+    G4String particle;
+    double energy_eV;
+    double length_cm;
+    std::vector<Track> tracks;
+  };
+
+  static HeedClusterLibrary* Instance();
+
+  // Entry of the particle within a relative energy tolerance. A missing
+  // entry is made by generate at the centre of the energy bin and appended to
+  // the file, nullptr once the library is full.
+  const Entry* Get(const G4String& file, const G4String& particle, double energy_eV,
+                   const std::function<Entry(double energy_eV)>& generate);
+
+  static constexpr double kEnergyTolerance = 0.01;
+  static constexpr std::size_t kMaxEntries = 64;
+
+ private:
+  HeedClusterLibrary() {}
+  void Load(const G4String& file);
+  void Append(const Entry&);
+
+  G4String fFile;
+  std::vector<std::unique_ptr<Entry>> fEntries;
+  G4bool fFullWarned = false;
+};
+
+#endif /* HEEDCLUSTERLIBRARY_H_ */
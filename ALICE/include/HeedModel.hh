@@ -26,6 +26,10 @@
 #include "GeometrySimple.hh"
 #include "GasModelParameters.hh"
 #include "GasBoxSD.hh"
+#include "WireSignalEngine.hh"
+#include "DriftLineRecorder.hh"
+
+#include <chrono>
 
 
 class G4VPhysicalVolume;
@@ -33,6 +37,7 @@ class DetectorConstruction;
 class HeedMessenger;
 class G4FastStep;
 class G4FastTrack;
+class DriftLineTrajectory;
 
 class HeedModel : public G4VFastSimulationModel {
  public:
@@ -53,6 +58,8 @@ class HeedModel : public G4VFastSimulationModel {
   virtual void ProcessEvent() = 0;
   //This method is called at the beginning of an event to reset some variables of the class
   virtual void Reset() = 0;
+  // Calls and time of each drift engine on this thread, printed and reset at the end of a run
+  static void PrintDriftStatistics();
   G4bool FindParticleName(G4String name);
   G4bool FindParticleNameEnergy(G4String name,double ekin_keV);
 
@@ -61,11 +68,28 @@ class HeedModel : public G4VFastSimulationModel {
   virtual void Run(G4FastStep& fastStep,const G4FastTrack& fastTrack, G4String particleName, double ekin_keV, double t, double x_cm, double y_cm, double z_cm, double dx, double dy, double dz) = 0;
   void PlotTrack();
   void Drift(double,double, double, double);
+  // Drift engines used by Drift. DriftRKFLine returns true when a hybrid drift line
+  // reaches the hand-off radius, the coordinates are then moved to that point.
+  bool DriftRKFLine(double& x, double& y, double& z, double& t, DriftLineTrajectory* dlt, bool handOff);
+  void DriftMCLine(double x, double y, double z, double t, DriftLineTrajectory* dlt);
+  void DriftMicroscopicLine(double x, double y, double z, double t, DriftLineTrajectory* dlt);
+  bool NearAnodeWire(double x, double y) const;
+  // Every electron contributes to the fast signals, drift lines for display and output are sampled
+  bool SampleDrift(int i) const;
+  // Simplify the points of fDriftLine, add them to the trajectory and the output
+  void FinishDriftLine(DriftLineTrajectory* dlt);
+  std::vector<DriftLineRecorder::Point> fDriftLine;
+  std::vector<DriftLineRecorder::Point> fSimplifiedLine;
   DetectorConstruction* detCon;
   HeedMessenger* fHeedMessenger;
 
   MapParticlesEnergy fMapParticlesEnergy;
 
+  // Energy ranges of a particle, looked up by name in fMapParticlesEnergy
+  // once per definition so that ModelTrigger only compares pointers
+  const std::vector<EnergyRange_keV>& TriggerRanges(const G4ParticleDefinition*);
+  std::vector<std::pair<const G4ParticleDefinition*, std::vector<EnergyRange_keV>>> fTriggerTable;
+
   G4String gasFile;
   G4String ionMobFile;
   
@@ -76,6 +100,16 @@ class HeedModel : public G4VFastSimulationModel {
   bool fVisualizeSignal;
   bool fVisualizeField;
   bool driftRKF;
+  bool driftHybrid;
+  double hybridRadius;
+  bool recordDriftLines;
+  double driftLineTolerance;
+  bool fastSignal;
+
+  double signalGain;
+  double signalBinWidth;
+  int signalBins;
+  int signalAngles;
 
   double vPlaneHV;
   double vPlaneLow;
@@ -95,8 +129,11 @@ class HeedModel : public G4VFastSimulationModel {
   void buildBox();
   void loadComsol();
   void BuildCompField();
+  // Wire chamber field; anodes trap electrons within anodeTrapRadius [cm], or at the Garfield default for 0
+  Garfield::ComponentAnalyticField* CreateCompField(double anodeTrapRadius);
   void BuildSensor();
   void SetTracking();
+  void BuildSignalEngine();
   void CreateChamberView();
   void CreateSignalView();
   void CreateFieldView();
@@ -108,6 +145,20 @@ class HeedModel : public G4VFastSimulationModel {
   Garfield::SolidTube* box;
   Garfield::ComponentVoxel* voxfield;
   Garfield::ComponentAnalyticField* comp;
+  // Field and sensor of the Runge-Kutta part of the hybrid drift
+  Garfield::ComponentAnalyticField* fCompRKF;
+  Garfield::Sensor* fSensorRKF;
+  std::vector<WireSignalEngine::Wire> fAnodeWires;
+
+  enum DriftEngine { kDriftRKF, kDriftMC, kDriftMicroscopic, kNDriftEngines };
+  struct DriftEngineStatistics {
+    G4long calls;
+    double seconds;
+  };
+  static G4ThreadLocal DriftEngineStatistics fDriftStatistics[kNDriftEngines];
+  // Adds the time since start to the engine
+  static void CountDrift(DriftEngine, std::chrono::steady_clock::time_point start);
+  double fWirePeriod;
   Garfield::AvalancheMC* fDrift;
   Garfield::DriftLineRKF* fDriftRKF;
   Garfield::AvalancheMicroscopic* fAvalanche;
@@ -22,6 +22,7 @@
 #include "ViewField.hh"
 #include "G4VFastSimulationModel.hh"
 #include "HeedModel.hh"
+#include "HeedClusterLibrary.hh"
 
 
 class G4VPhysicalVolume;
@@ -57,6 +58,15 @@ class HeedNewTrackModel : public HeedModel {
 
  private:
     virtual void Run(G4FastStep& fastStep,const G4FastTrack& fastTrack, G4String particleName, double ekin_keV, double t, double x_cm, double y_cm, double z_cm, double dx, double dy, double dz);
+    // Position where the primary leaves the gas without changing direction
+    G4ThreeVector ExitPosition(const G4FastTrack& fastTrack);
+    // Energy [eV] left by a track segment sampled from a cluster library entry
+    double SampleClusterLibrary(const HeedClusterLibrary::Entry* entry, double ekin_eV, double t, const G4ThreeVector& start_cm, const G4ThreeVector& dir, double length_cm, double speed_cm_ns);
+    HeedClusterLibrary::Entry GenerateClusterLibrary(G4String particleName, double ekin_eV);
+    void AddElectron(double x, double y, double z, double t, int i);
+
+    G4String clusterLibrary;
+    int clusterLibraryTracks;
   
   
 };
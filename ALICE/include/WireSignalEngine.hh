@@ -0,0 +1,75 @@
+/*
+ * WireSignalEngine.hh
+ *
+ * Fast induced signals for the wire chamber. The current induced on every
+ * readout electrode by one avalanche is computed once with Garfield (weighting
+ * field of ComponentAnalyticField, ion drift from the anode wire) for every
+ * anode wire and for a number of avalanche positions around it. Per event the
+ * electron arrivals are histogrammed per wire and position and convolved with
+ * these responses, by FFT for long windows, instead of integrating the
+ * weighting field along every drift line.
+ */
+
+#ifndef WIRESIGNALENGINE_H_
+#define WIRESIGNALENGINE_H_
+
+#include "globals.hh"
+#include "RadixFFT.hh"
+
+#include <vector>
+
+namespace Garfield {
+  class ComponentAnalyticField;
+}
+
+class WireSignalEngine {
+ public:
+  struct Wire {
+    double x, y, r;  // cm
+    G4String label;
+  };
+
+  // One engine per thread, shared by the Heed models of that thread
+  static WireSignalEngine* Instance();
+
+  void Build(Garfield::ComponentAnalyticField* comp, const std::vector<Wire>& anodes,
+             const std::vector<G4String>& electrodes, double period,
+             double binWidth, int nBins, int nAngles, double gain);
+  inline bool IsBuilt() const { return fBuilt; };
+
+  // Electron reaching (x, y) [cm] at time t [ns], ignored unless it ends on an anode wire
+  void AddArrival(double x, double y, double t);
+
+  // Fill one row of the Signal ntuple per electrode and clear the arrivals
+  void ProcessEvent(G4int eventID);
+
+  inline std::vector<double>& GetSamples() { return fSamples; };
+
+ private:
+  typedef radixfft::Complex Complex;
+
+  WireSignalEngine();
+  inline size_t Index(size_t wire, size_t angle) const { return wire*fNAngles + angle; };
+
+  bool fBuilt;
+  std::vector<Wire> fAnodes;
+  std::vector<G4String> fElectrodes;
+  double fPeriod;
+  double fBinWidth;
+  int fNBins;
+  int fNAngles;
+  double fGain;
+  size_t fFFTSize;  // 0 when convolving directly
+
+  // Responses per (wire, angle) and electrode, in the time or frequency domain
+  std::vector<std::vector<std::vector<double>>> fResponse;
+  std::vector<std::vector<std::vector<Complex>>> fSpectrum;
+
+  // Arrivals of this event per (wire, angle)
+  std::vector<std::vector<double>> fArrivals;
+  std::vector<bool> fHit;
+
+  std::vector<double> fSamples;  // row buffer of the Signal ntuple
+};
+
+#endif /* WIRESIGNALENGINE_H_ */
@@ -0,0 +1,23 @@
+#!/bin/bash
+# Throughput of ALICE from 1 to N threads with bench_scaling.mac.
+# Usage: ./scaling.sh [max_threads] [events_per_thread]
+# Run from the build directory, next to the ALICE executable.
+
+MAXTHREADS=${1:-$(nproc)}
+EVENTS=${2:-20}
+MACRO=$(dirname "$0")/bench_scaling.mac
+
+printf "%8s %10s %10s %12s %8s\n" threads events time[s] events/s speedup
+base=""
+for ((n = 1; n <= MAXTHREADS; n *= 2)); do
+    nev=$((EVENTS * n))
+    sed -e "s/NTHREADS/$n/" -e "s/NEVENTS/$nev/" "$MACRO" > scaling_$n.mac
+    start=$(date +%s.%N)
+    ./ALICE scaling_$n.mac 1 > scaling_$n.log 2>&1
+    end=$(date +%s.%N)
+    t=$(echo "$end - $start" | bc)
+    rate=$(echo "$nev / $t" | bc -l)
+    [ -z "$base" ] && base=$rate
+    printf "%8d %10d %10.1f %12.3f %8.2f\n" $n $nev $t $rate $(echo "$rate / $base" | bc -l)
+    rm -f scaling_$n.mac
+done
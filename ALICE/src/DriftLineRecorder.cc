@@ -0,0 +1,112 @@
+#include "DriftLineRecorder.hh"
+
+#include "Analysis.hh"
+
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+  const int kMaxOffset = 32767;  // int16
+  const int kMaxTime = 65535;    // uint16
+
+  // Distance of p from the segment a-b
+  double SegmentDistance2(const DriftLineRecorder::Point& p, const DriftLineRecorder::Point& a,
+                          const DriftLineRecorder::Point& b) {
+    double ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+    double vx = p.x - a.x, vy = p.y - a.y, vz = p.z - a.z;
+    double len2 = ux*ux + uy*uy + uz*uz;
+    double s = len2 > 0. ? std::max(0., std::min(1., (ux*vx + uy*vy + uz*vz)/len2)) : 0.;
+    double dx = vx - s*ux, dy = vy - s*uy, dz = vz - s*uz;
+    return dx*dx + dy*dy + dz*dz;
+  }
+}
+
+DriftLineRecorder* DriftLineRecorder::Instance() {
+  static G4ThreadLocal DriftLineRecorder* instance = nullptr;
+  if (!instance) instance = new DriftLineRecorder();
+  return instance;
+}
+
+void DriftLineRecorder::Simplify(const std::vector<Point>& line, double tolerance, std::vector<Point>& simplified) {
+  simplified.clear();
+  const size_t n = line.size();
+  if (n <= 2) {
+    simplified = line;
+    return;
+  }
+
+  // Iterative Douglas-Peucker over (first, last) index ranges
+  std::vector<bool> keep(n, false);
+  keep[0] = keep[n - 1] = true;
+  std::vector<std::pair<size_t, size_t>> ranges(1, std::make_pair(size_t(0), n - 1));
+  const double tolerance2 = tolerance*tolerance;
+  while (!ranges.empty()) {
+    size_t first = ranges.back().first, last = ranges.back().second;
+    ranges.pop_back();
+    double maxDistance2 = 0.;
+    size_t farthest = first;
+    for (size_t i = first + 1; i < last; i++) {
+      double d2 = SegmentDistance2(line[i], line[first], line[last]);
+      if (d2 > maxDistance2) {
+        maxDistance2 = d2;
+        farthest = i;
+      }
+    }
+    if (maxDistance2 > tolerance2) {
+      keep[farthest] = true;
+      ranges.push_back(std::make_pair(first, farthest));
+      ranges.push_back(std::make_pair(farthest, last));
+    }
+  }
+
+  for (size_t i = 0; i < n; i++)
+    if (keep[i]) simplified.push_back(line[i]);
+}
+
+void DriftLineRecorder::Record(const std::vector<Point>& line) {
+  if (line.empty()) return;
+
+  G4int event = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
+  if (event != fEvent) {
+    fEvent = event;
+    fLine = 0;
+  }
+
+  const Point& start = line.front();
+  double maxOffset = 0.;
+  for (const auto& p : line)
+    maxOffset = std::max({maxOffset, std::abs(p.x - start.x), std::abs(p.y - start.y), std::abs(p.z - start.z)});
+  double scale = maxOffset > 0. ? maxOffset/kMaxOffset : 1.;
+  double duration = std::max(0., line.back().t - start.t);
+  double timeScale = duration > 0. ? duration/kMaxTime : 1.;
+
+  fDX.clear();
+  fDY.clear();
+  fDZ.clear();
+  fDT.clear();
+  // Times are quantised from the start before taking differences, so errors do not add up
+  int previous = 0;
+  for (const auto& p : line) {
+    fDX.push_back((int)std::lround((p.x - start.x)/scale));
+    fDY.push_back((int)std::lround((p.y - start.y)/scale));
+    fDZ.push_back((int)std::lround((p.z - start.z)/scale));
+    int quantised = std::max(previous, std::min(kMaxTime, (int)std::lround((p.t - start.t)/timeScale)));
+    fDT.push_back(quantised - previous);
+    previous = quantised;
+  }
+
+  auto analysisManager = G4AnalysisManager::Instance();
+  analysisManager->FillNtupleDColumn(1, 0, event);
+  analysisManager->FillNtupleIColumn(1, 1, fLine++);
+  analysisManager->FillNtupleDColumn(1, 2, start.x);
+  analysisManager->FillNtupleDColumn(1, 3, start.y);
+  analysisManager->FillNtupleDColumn(1, 4, start.z);
+  analysisManager->FillNtupleDColumn(1, 5, start.t);
+  analysisManager->FillNtupleDColumn(1, 6, scale);
+  analysisManager->FillNtupleDColumn(1, 7, timeScale);
+  analysisManager->AddNtupleRow(1);
+}
@@ -10,6 +10,7 @@
 #include "DetectorConstruction.hh"
 #include "Analysis.hh"
 #include "SteppingAction.hh"
+#include "WireSignalEngine.hh"
 
 EventAction::EventAction() {
   
@@ -24,7 +25,8 @@ void EventAction::BeginOfEventAction(const G4Event *ev) {
 }
 
 void EventAction::EndOfEventAction(const G4Event *evt) {
-
+  WireSignalEngine* engine = WireSignalEngine::Instance();
+  if(engine->IsBuilt()) engine->ProcessEvent(evt->GetEventID());
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
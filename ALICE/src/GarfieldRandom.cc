@@ -0,0 +1,38 @@
+#include "GarfieldRandom.hh"
+
+#include "globals.hh"
+#include "Randomize.hh"
+#include "Random.hh"
+#include "TRandom3.h"
+
+namespace {
+  G4ThreadLocal TRandom3* threadEngine = nullptr;
+
+  TRandom3* ThreadEngine(){
+    // Threads that never called InitialiseThread (the master) keep the TRandom3 default seed
+    if(!threadEngine) threadEngine = new TRandom3(4357);
+    return threadEngine;
+  }
+
+  // The only state is the thread local engine, so one instance serves all threads
+  class ThreadRandom : public TRandom {
+  public:
+    Double_t Rndm() override {return ThreadEngine()->Rndm();}
+    void RndmArray(Int_t n, Float_t* array) override {ThreadEngine()->RndmArray(n, array);}
+    void RndmArray(Int_t n, Double_t* array) override {ThreadEngine()->RndmArray(n, array);}
+  };
+
+  // Installed during static initialisation, before any thread draws. The
+  // engine is never deleted, Garfield keeps a pointer to it until exit.
+  struct Installer {
+    Installer(){Garfield::randomEngine.SetEngine(new ThreadRandom());}
+  } installer;
+}
+
+void GarfieldRandom::InitialiseThread(){
+  if(threadEngine) return;
+  // TRandom3 takes a seed of 0 as a request for a time based one
+  UInt_t seed = 1 + UInt_t(G4UniformRand()*4294967294.);
+  threadEngine = new TRandom3(seed);
+  G4cout << "GarfieldRandom: thread seed " << seed << G4endl;
+}
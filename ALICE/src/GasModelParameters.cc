@@ -4,7 +4,10 @@
 #include "GasModelParametersMessenger.hh"
 #include "DetectorConstruction.hh"
 
-GasModelParameters::GasModelParameters(){
+GasModelParameters::GasModelParameters()
+  : fastSignal(false), driftHybrid(false), hybridRadius(0.05),
+    recordDriftLines(false), driftLineTolerance(1.e-3), signalGain(1.e4), signalBinWidth(1.), signalBins(1000), signalAngles(8),
+    clusterLibrary(""), clusterLibraryTracks(1000) {
 	fMessenger = new GasModelParametersMessenger(this);
 }
 
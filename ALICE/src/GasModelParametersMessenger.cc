@@ -79,6 +79,39 @@ GasModelParametersMessenger::GasModelParametersMessenger(GasModelParameters* gm)
   driftRKFCmd = new G4UIcmdWithABool("/gasModelParameters/heed/driftRKF",this);
   driftRKFCmd->SetGuidance("true if runge kutta is used for the drift");
 
+  driftHybridCmd = new G4UIcmdWithABool("/gasModelParameters/heed/drifthybrid",this);
+  driftHybridCmd->SetGuidance("true if runge kutta is used in the bulk and monte carlo (or microscopic) tracking near the anode wires");
+
+  hybridRadiusCmd = new G4UIcmdWithADouble("/gasModelParameters/heed/hybridradius",this);
+  hybridRadiusCmd->SetGuidance("Set the distance from the anode wires [cm] below which the hybrid drift hands over from runge kutta");
+
+  recordDriftLinesCmd = new G4UIcmdWithABool("/gasModelParameters/heed/recorddriftlines",this);
+  recordDriftLinesCmd->SetGuidance("true if the simplified drift lines are written to the DriftLines ntuple");
+
+  driftLineToleranceCmd = new G4UIcmdWithADouble("/gasModelParameters/heed/driftlinetolerance",this);
+  driftLineToleranceCmd->SetGuidance("Set the largest distance [cm] of a dropped drift line point from the simplified line");
+
+  fastSignalCmd = new G4UIcmdWithABool("/gasModelParameters/heed/fastsignal",this);
+  fastSignalCmd->SetGuidance("true if the wire signals are built from precomputed responses instead of the Garfield signal calculation");
+
+  signalGainCmd = new G4UIcmdWithADouble("/gasModelParameters/heed/signalgain",this);
+  signalGainCmd->SetGuidance("Set the avalanche gain of the anode wires for the fast signals");
+
+  signalBinWidthCmd = new G4UIcmdWithADouble("/gasModelParameters/heed/signalbinwidth",this);
+  signalBinWidthCmd->SetGuidance("Set the time bin width of the fast signals [ns]");
+
+  signalBinsCmd = new G4UIcmdWithAnInteger("/gasModelParameters/heed/signalbins",this);
+  signalBinsCmd->SetGuidance("Set the number of time bins of the fast signals");
+
+  signalAnglesCmd = new G4UIcmdWithAnInteger("/gasModelParameters/heed/signalangles",this);
+  signalAnglesCmd->SetGuidance("Set the number of avalanche positions around each anode wire for the fast signals");
+
+  clusterLibraryCmd = new G4UIcmdWithAString("/gasModelParameters/heed/clusterlibrary",this);
+  clusterLibraryCmd->SetGuidance("Set the file of the Heed cluster library, HeedNewTrack samples its tracks instead of running Heed");
+
+  clusterLibraryTracksCmd = new G4UIcmdWithAnInteger("/gasModelParameters/heed/clusterlibrarytracks",this);
+  clusterLibraryTracksCmd->SetGuidance("Set the number of Heed tracks generated for a particle and energy missing from the library");
+
   createAvalCmd = new G4UIcmdWithABool("/gasModelParameters/heed/createAval",this);
   createAvalCmd->SetGuidance("true if monte carlo simulation of an avalanches is to be used");
 
@@ -127,6 +160,17 @@ GasModelParametersMessenger::~GasModelParametersMessenger() {
   delete ionMobFileCmd;
   delete driftElectronsCmd;
   delete driftRKFCmd;
+  delete driftHybridCmd;
+  delete hybridRadiusCmd;
+  delete recordDriftLinesCmd;
+  delete driftLineToleranceCmd;
+  delete fastSignalCmd;
+  delete signalGainCmd;
+  delete signalBinWidthCmd;
+  delete signalBinsCmd;
+  delete signalAnglesCmd;
+  delete clusterLibraryCmd;
+  delete clusterLibraryTracksCmd;
   delete createAvalCmd;
   delete trackMicroCmd;
   delete visualizeChamberCmd;
@@ -159,6 +203,39 @@ void GasModelParametersMessenger::SetNewValue(G4UIcommand* command, G4String new
 	  else if(command == driftRKFCmd){
 	  	fGasModelParameters->SetDriftRKF(driftRKFCmd->GetNewBoolValue(newValues));
 	  }
+	  else if(command == driftHybridCmd){
+	  	fGasModelParameters->SetDriftHybrid(driftHybridCmd->GetNewBoolValue(newValues));
+	  }
+	  else if(command == hybridRadiusCmd){
+	  	fGasModelParameters->SetHybridRadius(hybridRadiusCmd->GetNewDoubleValue(newValues));
+	  }
+	  else if(command == recordDriftLinesCmd){
+	  	fGasModelParameters->SetRecordDriftLines(recordDriftLinesCmd->GetNewBoolValue(newValues));
+	  }
+	  else if(command == driftLineToleranceCmd){
+	  	fGasModelParameters->SetDriftLineTolerance(driftLineToleranceCmd->GetNewDoubleValue(newValues));
+	  }
+	  else if(command == fastSignalCmd){
+	  	fGasModelParameters->SetFastSignal(fastSignalCmd->GetNewBoolValue(newValues));
+	  }
+	  else if(command == signalGainCmd){
+	  	fGasModelParameters->SetSignalGain(signalGainCmd->GetNewDoubleValue(newValues));
+	  }
+	  else if(command == signalBinWidthCmd){
+	  	fGasModelParameters->SetSignalBinWidth(signalBinWidthCmd->GetNewDoubleValue(newValues));
+	  }
+	  else if(command == signalBinsCmd){
+	  	fGasModelParameters->SetSignalBins(signalBinsCmd->GetNewIntValue(newValues));
+	  }
+	  else if(command == signalAnglesCmd){
+	  	fGasModelParameters->SetSignalAngles(signalAnglesCmd->GetNewIntValue(newValues));
+	  }
+	  else if(command == clusterLibraryCmd){
+	  	fGasModelParameters->SetClusterLibrary(newValues);
+	  }
+	  else if(command == clusterLibraryTracksCmd){
+	  	fGasModelParameters->SetClusterLibraryTracks(clusterLibraryTracksCmd->GetNewIntValue(newValues));
+	  }
 	  else if(command == createAvalCmd){
 	  	fGasModelParameters->SetCreateAvalancheMC(createAvalCmd->GetNewBoolValue(newValues));
 	  }
@@ -0,0 +1,152 @@
+#include "HeedClusterLibrary.hh"
+
+#include "G4AutoLock.hh"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+namespace {
+  G4Mutex libraryMutex = G4MUTEX_INITIALIZER;
+  const char kMagic[8] = {'H', 'E', 'E', 'D', 'C', 'L', 'U', '1'};
+  // Sanity limits on the counts read from a file
+  const int32_t kMaxNameLength = 256;
+  const int32_t kMaxCount = 100000000;
+
+  template <class T> bool Read(std::ifstream& in, T& value) {
+    return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(T));
+  }
+  template <class T> void Write(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+}
+
+constexpr double HeedClusterLibrary::kEnergyTolerance;
+constexpr std::size_t HeedClusterLibrary::kMaxEntries;
+
+HeedClusterLibrary* HeedClusterLibrary::Instance() {
+  static HeedClusterLibrary instance;
+  return &instance;
+}
+
+const HeedClusterLibrary::Entry* HeedClusterLibrary::Get(const G4String& file, const G4String& particle,
+                                                         double energy_eV, const std::function<Entry(double)>& generate) {
+  G4AutoLock lock(&libraryMutex);
+  if (file != fFile) Load(file);
+
+  for (const auto& entry : fEntries) {
+    if (entry->particle == particle && std::abs(entry->energy_eV - energy_eV) <= kEnergyTolerance*energy_eV)
+      return entry.get();
+  }
+
+  if (fEntries.size() >= kMaxEntries) {
+    if (!fFullWarned) {
+      G4Exception("HeedClusterLibrary::Get", "HeedClusterLibrary005", JustWarning,
+                  ("library " + fFile + " is full, particles without an entry are transported by Heed").c_str());
+      fFullWarned = true;
+    }
+    return nullptr;
+  }
+
+  // Centre of the log energy bin, within kEnergyTolerance of the request
+  const double binWidth = std::log(1. + 2.*kEnergyTolerance);
+  const double centre_eV = std::exp(std::round(std::log(energy_eV)/binWidth)*binWidth);
+
+  G4cout << "HeedClusterLibrary: generating tracks of " << particle << " at " << centre_eV << " eV" << G4endl;
+  std::unique_ptr<Entry> entry(new Entry(generate(centre_eV)));
+  if (entry->tracks.empty() || entry->length_cm <= 0.) {
+    G4Exception("HeedClusterLibrary::Get", "HeedClusterLibrary001", FatalException,
+                ("no tracks generated for " + particle).c_str());
+  }
+  Append(*entry);
+  fEntries.push_back(std::move(entry));
+  return fEntries.back().get();
+}
+
+void HeedClusterLibrary::Load(const G4String& file) {
+  fFile = file;
+  fEntries.clear();
+  fFullWarned = false;
+
+  std::ifstream in(file, std::ios::binary);
+  if (!in) return;
+
+  char magic[8];
+  if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(magic)) != 0) {
+    G4Exception("HeedClusterLibrary::Load", "HeedClusterLibrary002", FatalException,
+                ("not a Heed cluster library: " + file).c_str());
+  }
+
+  // A count that could not be read or is out of range means a damaged file
+  auto check = [&](bool ok) {
+    if (!ok || !in) {
+      G4Exception("HeedClusterLibrary::Load", "HeedClusterLibrary003", FatalException,
+                  ("truncated or damaged Heed cluster library: " + file).c_str());
+    }
+  };
+
+  int32_t nameLength;
+  while (Read(in, nameLength)) {
+    check(nameLength > 0 && nameLength <= kMaxNameLength);
+    std::unique_ptr<Entry> entry(new Entry);
+    std::string name(nameLength, ' ');
+    in.read(&name[0], nameLength);
+    entry->particle = name;
+    int32_t nTracks = 0;
+    Read(in, entry->energy_eV);
+    Read(in, entry->length_cm);
+    Read(in, nTracks);
+    check(nTracks > 0 && nTracks <= kMaxCount && entry->energy_eV > 0. && entry->length_cm > 0.);
+    entry->tracks.resize(nTracks);
+    for (auto& track : entry->tracks) {
+      int32_t nClusters = 0;
+      Read(in, nClusters);
+      check(nClusters >= 0 && nClusters <= kMaxCount);
+      track.resize(nClusters);
+      for (auto& cluster : track) {
+        int32_t nElectrons = 0;
+        Read(in, cluster.s);
+        Read(in, cluster.u);
+        Read(in, cluster.v);
+        Read(in, cluster.energy);
+        Read(in, nElectrons);
+        check(nElectrons >= 0 && nElectrons <= kMaxCount);
+        cluster.electrons.resize(nElectrons);
+        in.read(reinterpret_cast<char*>(cluster.electrons.data()), nElectrons*sizeof(Electron));
+      }
+    }
+    check(true);
+    G4cout << "HeedClusterLibrary: " << entry->tracks.size() << " tracks of " << entry->particle
+           << " at " << entry->energy_eV << " eV from " << file << G4endl;
+    fEntries.push_back(std::move(entry));
+  }
+}
+
+void HeedClusterLibrary::Append(const Entry& entry) {
+  bool exists = (bool)std::ifstream(fFile, std::ios::binary);
+  std::ofstream out(fFile, std::ios::binary | std::ios::app);
+  if (!out) {
+    G4Exception("HeedClusterLibrary::Append", "HeedClusterLibrary004", JustWarning,
+                ("cannot write Heed cluster library " + fFile + ", tracks kept for this run only").c_str());
+    return;
+  }
+  if (!exists) out.write(kMagic, sizeof(kMagic));
+
+  Write(out, (int32_t)entry.particle.size());
+  out.write(entry.particle.data(), entry.particle.size());
+  Write(out, entry.energy_eV);
+  Write(out, entry.length_cm);
+  Write(out, (int32_t)entry.tracks.size());
+  for (const auto& track : entry.tracks) {
+    Write(out, (int32_t)track.size());
+    for (const auto& cluster : track) {
+      Write(out, cluster.s);
+      Write(out, cluster.u);
+      Write(out, cluster.v);
+      Write(out, cluster.energy);
+      Write(out, (int32_t)cluster.electrons.size());
+      out.write(reinterpret_cast<const char*>(cluster.electrons.data()), cluster.electrons.size()*sizeof(Electron));
+    }
+  }
+}
@@ -16,9 +16,6 @@
 #include "G4FastStep.hh"
 #include "G4FastTrack.hh"
 
-#include "G4AutoLock.hh"
-namespace{G4Mutex aMutex = G4MUTEX_INITIALIZER;}
-
 // HeedDeltaElectronModel derives from the HeedModel Class and uses the GasModelParameters Class to set some user-defined veriables
 HeedDeltaElectronModel::HeedDeltaElectronModel(GasModelParameters* gmp,G4String modelName, G4Region* envelope,DetectorConstruction* dc, GasBoxSD* sd)
     : HeedModel(modelName, envelope,dc,sd) {
@@ -32,6 +29,15 @@ HeedDeltaElectronModel::HeedDeltaElectronModel(GasModelParameters* gmp,G4String
         fVisualizeSignal = gmp->GetVisualizeSignals();
         fVisualizeField = gmp->GetVisualizeField();
         driftRKF = gmp->GetDriftRKF();
+        driftHybrid = gmp->GetDriftHybrid();
+        hybridRadius = gmp->GetHybridRadius();
+        fastSignal = gmp->GetFastSignal();
+        recordDriftLines = gmp->GetRecordDriftLines();
+        driftLineTolerance = gmp->GetDriftLineTolerance();
+        signalGain = gmp->GetSignalGain();
+        signalBinWidth = gmp->GetSignalBinWidth();
+        signalBins = gmp->GetSignalBins();
+        signalAngles = gmp->GetSignalAngles();
         vPlaneHV = gmp->GetVoltagePlaneHV();
         vPlaneLow = gmp->GetVoltagePlaneLow();
         vAnodeWires = gmp->GetVoltageAnodeWires();
@@ -52,12 +58,10 @@ void HeedDeltaElectronModel::Run(G4FastStep& fastStep,const G4FastTrack& fastTra
     G4cout << "Run Interface" << G4endl;
     G4cout << "Electron energy(in eV): " << eKin_eV << G4endl;
     if(particleName == "e-"){
-        G4AutoLock lock(&aMutex);
         fTrackHeed->TransportDeltaElectron(x_cm, y_cm, z_cm, t, eKin_eV, dx, dy,
                                            dz, nc, ni);
     }
     else{
-        G4AutoLock lock(&aMutex);
         fTrackHeed->TransportPhoton(x_cm, y_cm, z_cm, t, eKin_eV, dx, dy,
                                     dz, nc);
     }
@@ -69,7 +73,7 @@ void HeedDeltaElectronModel::Run(G4FastStep& fastStep,const G4FastTrack& fastTra
         gbh->SetPos(G4ThreeVector(xe*CLHEP::cm,ye*CLHEP::cm,ze*CLHEP::cm));
         gbh->SetTime(te);
         fGasBoxSD->InsertGasBoxHit(gbh);
-        if(G4VVisManager::GetConcreteInstance() && cl % 100 == 0)
+        if(SampleDrift(cl))
             Drift(xe,ye,ze,te);
     }
     PlotTrack();
@@ -1,4 +1,6 @@
 #include <iostream>
+#include <cmath>
+#include <algorithm>
 #include "HeedModel.hh"
 #include "G4VPhysicalVolume.hh"
 #include "G4Electron.hh"
@@ -11,12 +13,15 @@
 #include "G4TrackingManager.hh"
 #include "G4EventManager.hh"
 #include "G4VVisManager.hh"
+#include "GarfieldRandom.hh"
 
 #include "G4AutoLock.hh"
 namespace{G4Mutex aMutex = G4MUTEX_INITIALIZER;}
 
 const static G4double torr = 1. / 760. * atmosphere;
 
+G4ThreadLocal HeedModel::DriftEngineStatistics HeedModel::fDriftStatistics[HeedModel::kNDriftEngines] = {};
+
 
 HeedModel::HeedModel(G4String modelName, G4Region* envelope,DetectorConstruction* dc,GasBoxSD* sd)
 : G4VFastSimulationModel(modelName, envelope), detCon(dc), fGasBoxSD(sd)	{}
@@ -25,16 +30,30 @@ HeedModel::~HeedModel() {}
 
 //Method called when a particle is created, checks if the model is applicable for this particle
 G4bool HeedModel::IsApplicable(const G4ParticleDefinition& particleType) {
-  G4String particleName = particleType.GetParticleName();
-  return FindParticleName(particleName);
+  return !TriggerRanges(&particleType).empty();
 }
 
 //Method called in every step: checks if the conditions of the particle are met. If true the DoIt-method is called
 G4bool HeedModel::ModelTrigger(const G4FastTrack& fastTrack) {
-  G4double ekin = fastTrack.GetPrimaryTrack()->GetKineticEnergy();
-  G4String particleName =
-      fastTrack.GetPrimaryTrack()->GetParticleDefinition()->GetParticleName();
-  return FindParticleNameEnergy(particleName, ekin / keV);
+  G4double ekin_keV = fastTrack.GetPrimaryTrack()->GetKineticEnergy() / keV;
+  for (const auto& range : TriggerRanges(fastTrack.GetPrimaryTrack()->GetParticleDefinition())) {
+    if (range.first <= ekin_keV && range.second >= ekin_keV) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//Energy ranges of the particle, resolved by name the first time the definition is seen
+const std::vector<EnergyRange_keV>& HeedModel::TriggerRanges(const G4ParticleDefinition* particle) {
+  for (const auto& entry : fTriggerTable) {
+    if (entry.first == particle) return entry.second;
+  }
+  std::vector<EnergyRange_keV> ranges;
+  auto found = fMapParticlesEnergy.equal_range(particle->GetParticleName());
+  for (auto it = found.first; it != found.second; ++it) ranges.push_back(it->second);
+  fTriggerTable.emplace_back(particle, ranges);
+  return fTriggerTable.back().second;
 }
 
 //Implementation of the general model, the Run method, calles at the end is specifically implemented for the daughter classes
@@ -85,6 +104,8 @@ G4bool HeedModel::FindParticleNameEnergy(G4String name,
 void HeedModel::InitialisePhysics(){
   if(G4RunManager::GetRunManager()->GetRunManagerType() == G4RunManager::workerRM ||
      G4RunManager::GetRunManager()->GetRunManagerType() == G4RunManager::sequentialRM ){
+    GarfieldRandom::InitialiseThread();
+
     makeGas();
       
     buildBox();
@@ -95,6 +116,8 @@ void HeedModel::InitialisePhysics(){
     
     SetTracking();
     
+    if(fastSignal) BuildSignalEngine();
+    
     if(fVisualizeChamber) CreateChamberView();
     if(fVisualizeSignal) CreateSignalView();
     if(fVisualizeField) CreateFieldView();
@@ -136,6 +159,15 @@ void HeedModel::buildBox(){
 
 //Construction of the electric field (see Garfield++ documentation)
 void HeedModel::BuildCompField(){
+    comp = CreateCompField(0.);
+    // Second copy of the field for the Runge-Kutta part of the hybrid drift:
+    // DriftLineRKF ends a line in the trap radius of a wire, so with the trap
+    // radius of the anodes at the hand-off radius the near-wire integration
+    // is left to the detailed engine
+    if(driftHybrid) fCompRKF = CreateCompField(hybridRadius);
+}
+
+Garfield::ComponentAnalyticField* HeedModel::CreateCompField(double anodeTrapRadius){
     // Switch between IROC and OROC.
     const bool iroc = false;
     // Switch gating on or off.
@@ -159,12 +191,23 @@ void HeedModel::BuildCompField(){
     const double dCath = 0.0075;
     const double dGate = 0.0075;
     
-    comp = new Garfield::ComponentAnalyticField();
+    Garfield::ComponentAnalyticField* comp = new Garfield::ComponentAnalyticField();
     comp->SetGeometry(geo);
     
     comp->SetPeriodicityX(nRep * period);
+    fWirePeriod = nRep * period;
+    // Each anode wire is an electrode of its own for the fast signals
+    fAnodeWires.clear();
     for (int i = 0; i < nRep; ++i) {
-        comp->AddWire((i - 1) * period, (detCon->GetGasBoxH()*0.5)/CLHEP::cm - ys, dSens, vAnodeWires, "s");
+        WireSignalEngine::Wire wire;
+        wire.x = (i - 1) * period;
+        wire.y = (detCon->GetGasBoxH()*0.5)/CLHEP::cm - ys;
+        wire.r = 0.5 * dSens;
+        wire.label = "s" + std::to_string(i);
+        // Trap radius in wire radii, not beyond anodeTrapRadius; 5 is the Garfield default
+        const int nTrap = anodeTrapRadius > 0. ? std::max(1, (int)std::floor(anodeTrapRadius/wire.r)) : 5;
+        comp->AddWire(wire.x, wire.y, dSens, vAnodeWires, fastSignal ? wire.label : "s", 100., 50., 19.3, nTrap);
+        fAnodeWires.push_back(wire);
     }
     for (int i = 0; i < nRep; ++i) {
         comp->AddWire(dc * (i - 0.5),(detCon->GetGasBoxH()*0.5)/CLHEP::cm - yc, dCath, vCathodeWires, "c");
@@ -180,35 +223,42 @@ void HeedModel::BuildCompField(){
     // Set the magnetic field [T].
     comp->SetMagneticField(0, 0.5, 0);
     
-  
+    return comp;
 }
 
 //Build sensor (see Garfield++ documentation)
 void HeedModel::BuildSensor(){
   fSensor = new Garfield::Sensor();
   fSensor->AddComponent(comp);
+  if(driftHybrid){
+    fSensorRKF = new Garfield::Sensor();
+    fSensorRKF->AddComponent(fCompRKF);
+  }
   //fSensor->SetTimeWindow(0.,fBinWidth,fNbins); //Lowest time [ns], time bins [ns], number of bins
 }
 
 //Set which tracking mechanism to be used: Runge-kutta, Monte-Carlo or Microscopic (see Garfield++ documentation)
 void HeedModel::SetTracking(){
-  if(driftRKF){
+  if(driftRKF || driftHybrid){
     fDriftRKF = new Garfield::DriftLineRKF();
-    fDriftRKF->SetSensor(fSensor);
-    fDriftRKF->EnableDebugging();
+    fDriftRKF->SetSensor(driftHybrid ? fSensorRKF : fSensor);
+    if(!driftHybrid) fDriftRKF->EnableDebugging();
   }
-  else if(trackMicro){
-    fAvalanche = new Garfield::AvalancheMicroscopic();
-    fAvalanche->SetSensor(fSensor);
-    fAvalanche->EnableSignalCalculation();
-  }
-  else{  
-    fDrift = new Garfield::AvalancheMC();
-    fDrift->SetSensor(fSensor);
-    fDrift->EnableSignalCalculation();
-    fDrift->SetDistanceSteps(2.e-3);
-    if(createAval) fDrift->EnableAttachment();
-    else fDrift->DisableAttachment();
+  // The hybrid drift also needs the engine used near the wires
+  if(!driftRKF || driftHybrid){
+    if(trackMicro){
+      fAvalanche = new Garfield::AvalancheMicroscopic();
+      fAvalanche->SetSensor(fSensor);
+      if(!fastSignal) fAvalanche->EnableSignalCalculation();
+    }
+    else{  
+      fDrift = new Garfield::AvalancheMC();
+      fDrift->SetSensor(fSensor);
+      if(!fastSignal) fDrift->EnableSignalCalculation();
+      fDrift->SetDistanceSteps(2.e-3);
+      if(createAval) fDrift->EnableAttachment();
+      else fDrift->DisableAttachment();
+    }
   }
   fTrackHeed = new Garfield::TrackHeed();
   fTrackHeed->SetSensor(fSensor);
@@ -217,6 +267,18 @@ void HeedModel::SetTracking(){
 
 }
 
+// Responses of the readout electrodes to one avalanche on each anode wire, shared by the models of the thread
+void HeedModel::BuildSignalEngine(){
+  WireSignalEngine* engine = WireSignalEngine::Instance();
+  if(engine->IsBuilt()) return;
+  std::vector<G4String> electrodes;
+  for(const auto& wire : fAnodeWires) electrodes.push_back(wire.label);
+  electrodes.push_back("c");
+  electrodes.push_back("g");
+  electrodes.push_back("pad_plane");
+  engine->Build(comp, fAnodeWires, electrodes, fWirePeriod, signalBinWidth, signalBins, signalAngles, signalGain);
+}
+
 // Set some visualization variables to see tracks and drift lines (see Garfield++ documentation)
 void HeedModel::CreateChamberView(){
   char str[30];
@@ -237,9 +299,11 @@ void HeedModel::CreateChamberView(){
   
   viewDrift = new Garfield::ViewDrift();
   viewDrift->SetCanvas(fChamber);
-  if(driftRKF) fDriftRKF->EnablePlotting(viewDrift);
-  else if(trackMicro) fAvalanche->EnablePlotting(viewDrift);
-  else fDrift->EnablePlotting(viewDrift);
+  if(driftRKF || driftHybrid) fDriftRKF->EnablePlotting(viewDrift);
+  if(!driftRKF || driftHybrid){
+    if(trackMicro) fAvalanche->EnablePlotting(viewDrift);
+    else fDrift->EnablePlotting(viewDrift);
+  }
   fTrackHeed->EnablePlotting(viewDrift);
 
 }
@@ -277,42 +341,136 @@ void HeedModel::CreateFieldView(){
 // Drift the electrons from point of creation towards the electrodes (This is common for both models, i.e. HeedDeltaElectron and HeedModel) (see Garfield++ documentation)
 void HeedModel::Drift(double x, double y, double z, double t){
     if(driftElectrons){
-        DriftLineTrajectory* dlt = new DriftLineTrajectory();
-        G4TrackingManager* fpTrackingManager = G4EventManager::GetEventManager()->GetTrackingManager();
-        fpTrackingManager->SetTrajectory(dlt);
-        if(driftRKF){
-            fDriftRKF->DriftElectron(x,y,z,t);
-            unsigned int n = fDriftRKF->GetNumberOfDriftLinePoints();
-            double xi,yi,zi,ti;
-            for(int i=0;i<n;i++){
-                fDriftRKF->GetDriftLinePoint(i,xi,yi,zi,ti);
-                if(G4VVisManager::GetConcreteInstance() && i % 1000 == 0)
-                  dlt->AppendStep(G4ThreeVector(xi*CLHEP::cm,yi*CLHEP::cm,zi*CLHEP::cm),ti);
-            }
+        // Drift lines are only kept for visualisation
+        DriftLineTrajectory* dlt = nullptr;
+        if(G4VVisManager::GetConcreteInstance()){
+            dlt = new DriftLineTrajectory();
+            G4TrackingManager* fpTrackingManager = G4EventManager::GetEventManager()->GetTrackingManager();
+            fpTrackingManager->SetTrajectory(dlt);
         }
-        else if(trackMicro){
-            fAvalanche->AvalancheElectron(x,y,z,t,0,0,0,0);
-            unsigned int nLines = fAvalanche->GetNumberOfElectronEndpoints();
-            for(int i=0;i<nLines;i++){
-                unsigned int n = fAvalanche->GetNumberOfElectronDriftLinePoints(i);
-                double xi,yi,zi,ti;
-                for(int j=0;j<n;j++){
-                    fAvalanche->GetElectronDriftLinePoint(xi,yi,zi,ti,j,i);
-                    if(G4VVisManager::GetConcreteInstance() && i % 1000 == 0)
-                      dlt->AppendStep(G4ThreeVector(xi*CLHEP::cm,yi*CLHEP::cm,zi*CLHEP::cm),ti);
-                }
-            }
+        if(driftHybrid){
+            // Runge-Kutta through the bulk, the detailed engine only inside the hand-off radius
+            if(!NearAnodeWire(x,y) && !DriftRKFLine(x,y,z,t,dlt,true)) return;
         }
-        else{
-            fDrift->DriftElectron(x,y,z,t);
-            unsigned int n = fDrift->GetNumberOfDriftLinePoints();
-            double xi,yi,zi,ti;
-            for(int i=0;i<n;i++){
-                fDrift->GetDriftLinePoint(i,xi,yi,zi,ti);
-                if(G4VVisManager::GetConcreteInstance() && i % 1000 == 0)
-                  dlt->AppendStep(G4ThreeVector(xi*CLHEP::cm,yi*CLHEP::cm,zi*CLHEP::cm),ti);
-            }
+        else if(driftRKF){
+            DriftRKFLine(x,y,z,t,dlt,false);
+            return;
         }
+        if(trackMicro) DriftMicroscopicLine(x,y,z,t,dlt);
+        else DriftMCLine(x,y,z,t,dlt);
+    }
+}
+
+bool HeedModel::DriftRKFLine(double& x, double& y, double& z, double& t, DriftLineTrajectory* dlt, bool handOff){
+    auto start = std::chrono::steady_clock::now();
+    WireSignalEngine* engine = fastSignal ? WireSignalEngine::Instance() : nullptr;
+    const bool keepLine = dlt || recordDriftLines;
+    // In the hybrid drift the line already ends at the anode trap radius, see BuildCompField
+    fDriftRKF->DriftElectron(x,y,z,t);
+    unsigned int n = fDriftRKF->GetNumberOfDriftLinePoints();
+    double xi,yi,zi,ti;
+    for(int i=0;i<n;i++){
+        fDriftRKF->GetDriftLinePoint(i,xi,yi,zi,ti);
+        if(keepLine) fDriftLine.push_back({xi,yi,zi,ti});
+        if(handOff && NearAnodeWire(xi,yi)){
+            x = xi; y = yi; z = zi; t = ti;
+            FinishDriftLine(dlt);
+            CountDrift(kDriftRKF, start);
+            return true;
+        }
+    }
+    FinishDriftLine(dlt);
+    if(engine && n > 0){
+        fDriftRKF->GetDriftLinePoint(n-1,xi,yi,zi,ti);
+        engine->AddArrival(xi,yi,ti);
+    }
+    CountDrift(kDriftRKF, start);
+    return false;
+}
+
+void HeedModel::DriftMCLine(double x, double y, double z, double t, DriftLineTrajectory* dlt){
+    auto start = std::chrono::steady_clock::now();
+    WireSignalEngine* engine = fastSignal ? WireSignalEngine::Instance() : nullptr;
+    const bool keepLine = dlt || recordDriftLines;
+    fDrift->DriftElectron(x,y,z,t);
+    unsigned int n = fDrift->GetNumberOfDriftLinePoints();
+    double xi,yi,zi,ti;
+    for(int i=0;keepLine && i<n;i++){
+        fDrift->GetDriftLinePoint(i,xi,yi,zi,ti);
+        fDriftLine.push_back({xi,yi,zi,ti});
+    }
+    FinishDriftLine(dlt);
+    if(engine && n > 0){
+        fDrift->GetDriftLinePoint(n-1,xi,yi,zi,ti);
+        engine->AddArrival(xi,yi,ti);
+    }
+    CountDrift(kDriftMC, start);
+}
+
+void HeedModel::DriftMicroscopicLine(double x, double y, double z, double t, DriftLineTrajectory* dlt){
+    auto start = std::chrono::steady_clock::now();
+    WireSignalEngine* engine = fastSignal ? WireSignalEngine::Instance() : nullptr;
+    const bool keepLine = dlt || recordDriftLines;
+    fAvalanche->AvalancheElectron(x,y,z,t,0,0,0,0);
+    unsigned int nLines = fAvalanche->GetNumberOfElectronEndpoints();
+    for(int i=0;i<nLines;i++){
+        unsigned int n = keepLine ? fAvalanche->GetNumberOfElectronDriftLinePoints(i) : 0;
+        double xi,yi,zi,ti;
+        for(int j=0;j<n;j++){
+            fAvalanche->GetElectronDriftLinePoint(xi,yi,zi,ti,j,i);
+            fDriftLine.push_back({xi,yi,zi,ti});
+        }
+        FinishDriftLine(dlt);
+        if(engine){
+            double x0,y0,z0,t0,e0,x1,y1,z1,t1,e1;
+            int status;
+            fAvalanche->GetElectronEndpoint(i,x0,y0,z0,t0,e0,x1,y1,z1,t1,e1,status);
+            engine->AddArrival(x1,y1,t1);
+        }
+    }
+    CountDrift(kDriftMicroscopic, start);
+}
+
+bool HeedModel::SampleDrift(int i) const{
+    return fastSignal || ((recordDriftLines || G4VVisManager::GetConcreteInstance()) && i % 100 == 0);
+}
+
+void HeedModel::FinishDriftLine(DriftLineTrajectory* dlt){
+    if(fDriftLine.empty()) return;
+    DriftLineRecorder::Simplify(fDriftLine, driftLineTolerance, fSimplifiedLine);
+    fDriftLine.clear();
+    if(dlt){
+        for(const auto& p : fSimplifiedLine)
+            dlt->AppendStep(G4ThreeVector(p.x*CLHEP::cm,p.y*CLHEP::cm,p.z*CLHEP::cm),p.t);
+    }
+    if(recordDriftLines) DriftLineRecorder::Instance()->Record(fSimplifiedLine);
+}
+
+// Within the hand-off radius of an anode wire or of one of its periodic images
+bool HeedModel::NearAnodeWire(double x, double y) const{
+    for(const auto& wire : fAnodeWires){
+        double dx = x - wire.x;
+        if(fWirePeriod > 0.) dx -= fWirePeriod*std::round(dx/fWirePeriod);
+        double dy = y - wire.y;
+        if(dx*dx + dy*dy < hybridRadius*hybridRadius) return true;
+    }
+    return false;
+}
+
+void HeedModel::CountDrift(DriftEngine e, std::chrono::steady_clock::time_point start){
+    fDriftStatistics[e].calls++;
+    fDriftStatistics[e].seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void HeedModel::PrintDriftStatistics(){
+    const char* names[kNDriftEngines] = {"DriftLineRKF", "AvalancheMC", "AvalancheMicroscopic"};
+    for(int e = 0; e < kNDriftEngines; e++){
+        if(fDriftStatistics[e].calls == 0) continue;
+        G4cout << "Drift " << names[e] << ": " << fDriftStatistics[e].calls << " calls, "
+               << fDriftStatistics[e].seconds << " s, "
+               << 1.e6*fDriftStatistics[e].seconds/fDriftStatistics[e].calls << " us per call" << G4endl;
+        fDriftStatistics[e].calls = 0;
+        fDriftStatistics[e].seconds = 0.;
     }
 }
 
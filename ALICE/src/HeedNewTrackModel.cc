@@ -5,6 +5,8 @@
  *      Author: dpfeiffe
  */
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 #include "HeedNewTrackModel.hh"
 #include "G4VPhysicalVolume.hh"
 #include "G4Electron.hh"
@@ -22,11 +24,10 @@
 #include "G4PathFinder.hh"
 #include "G4FastStep.hh"
 #include "G4FastTrack.hh"
+#include "Randomize.hh"
+#include "DetectorConstruction.hh"
 
 
-#include "G4AutoLock.hh"
-namespace{G4Mutex aMutex = G4MUTEX_INITIALIZER;}
-
 // HeedNewTrackModel derives from the HeedModel Class and uses the GasModelParameters Class to set some user-defined veriables
 HeedNewTrackModel::HeedNewTrackModel(GasModelParameters* gmp,G4String modelName, G4Region* envelope,DetectorConstruction* dc, GasBoxSD* sd)
     : HeedModel(modelName, envelope,dc,sd)	{
@@ -43,6 +44,17 @@ HeedNewTrackModel::HeedNewTrackModel(GasModelParameters* gmp,G4String modelName,
         fVisualizeSignal = gmp->GetVisualizeSignals();
         fVisualizeField = gmp->GetVisualizeField();
         driftRKF = gmp->GetDriftRKF();
+        driftHybrid = gmp->GetDriftHybrid();
+        hybridRadius = gmp->GetHybridRadius();
+        fastSignal = gmp->GetFastSignal();
+        recordDriftLines = gmp->GetRecordDriftLines();
+        driftLineTolerance = gmp->GetDriftLineTolerance();
+        signalGain = gmp->GetSignalGain();
+        signalBinWidth = gmp->GetSignalBinWidth();
+        signalBins = gmp->GetSignalBins();
+        signalAngles = gmp->GetSignalAngles();
+        clusterLibrary = gmp->GetClusterLibrary();
+        clusterLibraryTracks = gmp->GetClusterLibraryTracks();
         vPlaneHV = gmp->GetVoltagePlaneHV();
         vPlaneLow = gmp->GetVoltagePlaneLow();
         vAnodeWires = gmp->GetVoltageAnodeWires();
@@ -59,29 +71,44 @@ HeedNewTrackModel::~HeedNewTrackModel() {}
 void HeedNewTrackModel::Run(G4FastStep& fastStep,const G4FastTrack& fastTrack, G4String particleName, double ekin_keV, double t, double x_cm,
             double y_cm, double z_cm, double dx, double dy, double dz){
     double ekin_eV = ekin_keV * 1000;
-    fTrackHeed->EnableDebugging();
-    fTrackHeed->SetParticle(particleName);
-    fTrackHeed->SetEnergy(ekin_eV);
-    fTrackHeed->NewTrack(x_cm, y_cm, z_cm, t, dx, dy, dz);
-    double xcl, ycl, zcl, tcl, ecl, extra;
-    int ncl = 0;
-    while (fTrackHeed->GetCluster(xcl, ycl, zcl, tcl, ncl, ecl, extra)) {
-        ekin_eV-=ecl;
-        std::cout << "New Cluster: " << xcl << " " << ycl << " " << zcl << std::endl;
-    // Retrieve the electrons of the cluster.
-        for (int i = 0; i < ncl; ++i) {
-            double x, y, z, te, ee, dxe, dye, dze;
-            fTrackHeed->GetElectron(i, x, y, z, te, ee, dxe, dye, dze);
-            GasBoxHit* gbh = new GasBoxHit();
-            gbh->SetPos(G4ThreeVector(x*CLHEP::cm,y*CLHEP::cm,z*CLHEP::cm));
-            gbh->SetTime(te);
-            fGasBoxSD->InsertGasBoxHit(gbh);
-            if(G4VVisManager::GetConcreteInstance() && i % 100 == 0)
-                Drift(x,y,z,te);
+    // try to estimate the exit location of the high energy particle out of the gas volume from the initial location and momentum direction and update the track parameters: location, direction, energy
+    G4ThreeVector exitPosition = ExitPosition(fastTrack);
+    const HeedClusterLibrary::Entry* entry = nullptr;
+    if(clusterLibrary != "")
+        entry = HeedClusterLibrary::Instance()->Get(clusterLibrary, particleName, ekin_eV,
+            [&](double energy_eV){ return GenerateClusterLibrary(particleName, energy_eV); });
+    if(entry){
+        G4ThreeVector start(x_cm, y_cm, z_cm);
+        double length_cm = (exitPosition/CLHEP::cm - start).mag();
+        double speed_cm_ns = fastTrack.GetPrimaryTrack()->GetVelocity()/(CLHEP::cm/CLHEP::ns);
+        ekin_eV -= SampleClusterLibrary(entry, ekin_eV, t, start, G4ThreeVector(dx,dy,dz), length_cm, speed_cm_ns);
+    }
+    else{
+        fTrackHeed->SetParticle(particleName);
+        fTrackHeed->SetEnergy(ekin_eV);
+        fTrackHeed->NewTrack(x_cm, y_cm, z_cm, t, dx, dy, dz);
+        double xcl, ycl, zcl, tcl, ecl, extra;
+        int ncl = 0;
+        while (fTrackHeed->GetCluster(xcl, ycl, zcl, tcl, ncl, ecl, extra)) {
+            ekin_eV-=ecl;
+        // Retrieve the electrons of the cluster.
+            for (int i = 0; i < ncl; ++i) {
+                double x, y, z, te, ee, dxe, dye, dze;
+                fTrackHeed->GetElectron(i, x, y, z, te, ee, dxe, dye, dze);
+                AddElectron(x, y, z, te, i);
+            }
         }
     }
     PlotTrack();
-    // try to estimate the exit location of the high energy particle out of the gas volume from the initial location and momentum direction and update the track parameters: location, direction, energy
+    
+    // Place the particle at the tracking detector exit
+    // (at the place it would reach without the change of its momentum).
+    fastStep.ProposePrimaryTrackFinalPosition( exitPosition, false );
+    fastStep.SetPrimaryTrackFinalKineticEnergyAndDirection(ekin_eV*eV, G4ThreeVector(dx,dy,dz),false);
+    fastStep.SetTotalEnergyDeposited((ekin_keV*1000-ekin_eV)*eV);
+}
+
+G4ThreeVector HeedNewTrackModel::ExitPosition(const G4FastTrack& fastTrack){
     G4Track track = * fastTrack.GetPrimaryTrack();
     G4FieldTrack aFieldTrack( '0' );
     G4FieldTrackUpdator::Update( &aFieldTrack, &track );
@@ -92,7 +119,6 @@ void HeedNewTrackModel::Run(G4FastStep& fastStep,const G4FastTrack& fastTrack, G
     G4double currentMinimumStep = 1.00*m;  // Temporary: change that to sth connected
     // to particle momentum.
     G4PathFinder* fPathFinder = G4PathFinder::GetInstance();
-    fPathFinder->SetVerboseLevel(3);
     /*G4double lengthAlongCurve = */
     fPathFinder->ComputeStep( aFieldTrack,
                              currentMinimumStep,
@@ -102,15 +128,88 @@ void HeedNewTrackModel::Run(G4FastStep& fastStep,const G4FastTrack& fastTrack, G
                              retStepLimited,
                              endTrack,
                              fastTrack.GetPrimaryTrack()->GetVolume() );
-    
-    // Place the particle at the tracking detector exit
-    // (at the place it would reach without the change of its momentum).
-    fastStep.ProposePrimaryTrackFinalPosition( endTrack.GetPosition(), false );
-    G4cout << "Particle location: " << endTrack.GetPosition() << G4endl;
-    G4cout << "Step No: " << fastTrack.GetPrimaryTrack()->GetCurrentStepNumber() << G4endl;
-    fastStep.SetPrimaryTrackFinalKineticEnergyAndDirection(ekin_eV*eV, G4ThreeVector(dx,dy,dz),false);
-    fastStep.SetTotalEnergyDeposited((ekin_keV*1000-ekin_eV)*eV);
-    std::cout << "Particle Tracked out of the gas volume" << std::endl;
+    return endTrack.GetPosition();
+}
+
+// Record an ionisation electron in the gas and drift it when needed
+void HeedNewTrackModel::AddElectron(double x, double y, double z, double t, int i){
+    GasBoxHit* gbh = new GasBoxHit();
+    gbh->SetPos(G4ThreeVector(x*CLHEP::cm,y*CLHEP::cm,z*CLHEP::cm));
+    gbh->SetTime(t);
+    fGasBoxSD->InsertGasBoxHit(gbh);
+    if(SampleDrift(i))
+        Drift(x,y,z,t);
+}
+
+// Lay stored tracks along the path of the primary, from a random offset and with a random
+// rotation around the direction, chaining tracks when the path is longer than the stored ones
+double HeedNewTrackModel::SampleClusterLibrary(const HeedClusterLibrary::Entry* entry, double ekin_eV, double t, const G4ThreeVector& start_cm,
+            const G4ThreeVector& dir, double length_cm, double speed_cm_ns){
+    G4ThreeVector e1 = dir.orthogonal().unit();
+    e1.rotate(CLHEP::twopi*G4UniformRand(), dir);
+    G4ThreeVector e2 = dir.cross(e1);
+
+    const double rMax = detCon->GetGasBoxR()/CLHEP::cm;
+    const double hMax = 0.5*detCon->GetGasBoxH()/CLHEP::cm;
+    auto inside = [&](const G4ThreeVector& p){ return p.x()*p.x() + p.z()*p.z() < rMax*rMax && std::abs(p.y()) < hMax; };
+
+    double deposited = 0.;
+    double covered = 0.;
+    while(covered < length_cm){
+        const HeedClusterLibrary::Track& track = entry->tracks[G4int(G4UniformRand()*entry->tracks.size()) % entry->tracks.size()];
+        double piece = std::min(length_cm - covered, entry->length_cm);
+        double s0 = G4UniformRand()*(entry->length_cm - piece);
+        for(const auto& cluster : track){
+            if(cluster.s < s0 || cluster.s >= s0 + piece) continue;
+            double along = covered + cluster.s - s0;
+            G4ThreeVector pos = start_cm + along*dir + cluster.u*e1 + cluster.v*e2;
+            if(!inside(pos)) continue;
+            deposited += cluster.energy;
+            double tcl = t + along/speed_cm_ns;
+            for(size_t i = 0; i < cluster.electrons.size(); ++i){
+                const HeedClusterLibrary::Electron& e = cluster.electrons[i];
+                G4ThreeVector pe = pos + e.ds*dir + e.du*e1 + e.dv*e2;
+                if(inside(pe)) AddElectron(pe.x(), pe.y(), pe.z(), tcl + e.dt, i);
+            }
+        }
+        covered += piece;
+    }
+    return std::min(deposited, ekin_eV);
+}
+
+// Heed tracks along the axis of the gas box, stored in the frame of the track
+HeedClusterLibrary::Entry HeedNewTrackModel::GenerateClusterLibrary(G4String particleName, double ekin_eV){
+    HeedClusterLibrary::Entry entry;
+    entry.particle = particleName;
+    entry.energy_eV = ekin_eV;
+    const double y0 = -0.5*detCon->GetGasBoxH()/CLHEP::cm + 1.e-4;
+    entry.length_cm = detCon->GetGasBoxH()/CLHEP::cm - 2.e-4;
+
+    fTrackHeed->SetParticle(particleName);
+    fTrackHeed->SetEnergy(ekin_eV);
+    for(int n = 0; n < clusterLibraryTracks; n++){
+        fTrackHeed->NewTrack(0., y0, 0., 0., 0., 1., 0.);
+        HeedClusterLibrary::Track track;
+        double xcl, ycl, zcl, tcl, ecl, extra;
+        int ncl = 0;
+        while (fTrackHeed->GetCluster(xcl, ycl, zcl, tcl, ncl, ecl, extra)) {
+            // Direction along y, first transverse axis along x, second along -z
+            HeedClusterLibrary::Cluster cluster;
+            cluster.s = ycl - y0;
+            cluster.u = xcl;
+            cluster.v = -zcl;
+            cluster.energy = ecl;
+            for (int i = 0; i < ncl; ++i) {
+                double x, y, z, te, ee, dxe, dye, dze;
+                fTrackHeed->GetElectron(i, x, y, z, te, ee, dxe, dye, dze);
+                HeedClusterLibrary::Electron e = {float(y - ycl), float(x - xcl), float(zcl - z), float(te - tcl)};
+                cluster.electrons.push_back(e);
+            }
+            track.push_back(cluster);
+        }
+        entry.tracks.push_back(track);
+    }
+    return entry;
 }
 
 
@@ -9,6 +9,9 @@
 #include "GasBoxSD.hh"
 #include "G4SDManager.hh"
 #include "G4RunManager.hh"
+#include "WireSignalEngine.hh"
+#include "HeedModel.hh"
+#include "DriftLineRecorder.hh"
 
 RunAction::RunAction(){
   G4cout << "Creating AnalysisManager" << G4endl;
@@ -22,6 +25,31 @@ RunAction::RunAction(){
   
   analysisManager->SetNtupleActivation(false);
 
+  // Fast wire signals, filled when /gasModelParameters/heed/fastsignal is on
+  analysisManager->CreateNtuple("Signal", "Induced current per electrode");
+  analysisManager->CreateNtupleDColumn("Event");
+  analysisManager->CreateNtupleSColumn("Electrode");
+  analysisManager->CreateNtupleDColumn("BinWidth");
+  analysisManager->CreateNtupleDColumn("Current", WireSignalEngine::Instance()->GetSamples());
+  analysisManager->FinishNtuple();
+
+  // Simplified drift lines, filled when /gasModelParameters/heed/recorddriftlines is on
+  DriftLineRecorder* recorder = DriftLineRecorder::Instance();
+  analysisManager->CreateNtuple("DriftLines", "Simplified and quantised drift lines");
+  analysisManager->CreateNtupleDColumn("Event");
+  analysisManager->CreateNtupleIColumn("Line");
+  analysisManager->CreateNtupleDColumn("X0");
+  analysisManager->CreateNtupleDColumn("Y0");
+  analysisManager->CreateNtupleDColumn("Z0");
+  analysisManager->CreateNtupleDColumn("T0");
+  analysisManager->CreateNtupleDColumn("Scale");
+  analysisManager->CreateNtupleDColumn("TimeScale");
+  analysisManager->CreateNtupleIColumn("DX", recorder->GetDX());
+  analysisManager->CreateNtupleIColumn("DY", recorder->GetDY());
+  analysisManager->CreateNtupleIColumn("DZ", recorder->GetDZ());
+  analysisManager->CreateNtupleIColumn("DT", recorder->GetDT());
+  analysisManager->FinishNtuple();
+
   G4cout << "Creating RunAction" << G4endl;
 }
 
@@ -48,6 +76,7 @@ void RunAction::BeginOfRunAction(const G4Run* aRun) {
 }
 
 void RunAction::EndOfRunAction(const G4Run* aRun) {
+  HeedModel::PrintDriftStatistics();
   auto analysisManager = G4AnalysisManager::Instance();
   analysisManager->Write();
   analysisManager->CloseFile();
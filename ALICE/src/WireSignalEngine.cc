@@ -0,0 +1,165 @@
+#include "WireSignalEngine.hh"
+
+#include "ComponentAnalyticField.hh"
+#include "AvalancheMC.hh"
+#include "Sensor.hh"
+#include "Medium.hh"
+#include "Analysis.hh"
+
+#include "G4PhysicalConstants.hh"
+
+#include <algorithm>
+#include <cmath>
+
+WireSignalEngine* WireSignalEngine::Instance() {
+  static G4ThreadLocal WireSignalEngine* instance = nullptr;
+  if (!instance) instance = new WireSignalEngine();
+  return instance;
+}
+
+WireSignalEngine::WireSignalEngine()
+  : fBuilt(false), fPeriod(0.), fBinWidth(1.), fNBins(0), fNAngles(1), fGain(1.), fFFTSize(0) {}
+
+void WireSignalEngine::Build(Garfield::ComponentAnalyticField* comp, const std::vector<Wire>& anodes,
+                             const std::vector<G4String>& electrodes, double period,
+                             double binWidth, int nBins, int nAngles, double gain) {
+  fAnodes = anodes;
+  fElectrodes = electrodes;
+  fPeriod = period;
+  fBinWidth = binWidth;
+  fNBins = nBins;
+  fNAngles = nAngles > 0 ? nAngles : 1;
+  fGain = gain;
+
+  // Sensor of its own so that the tracking sensor keeps no electrodes
+  Garfield::Sensor sensor;
+  sensor.AddComponent(comp);
+  for (const auto& label : fElectrodes) {
+    comp->AddReadout(label);
+    sensor.AddElectrode(comp, label);
+  }
+  sensor.SetTimeWindow(0., fBinWidth, fNBins);
+
+  // Without ion transport data every response would stay zero
+  for (const auto& wire : fAnodes) {
+    double ex, ey, ez, vx, vy, vz;
+    Garfield::Medium* medium = nullptr;
+    int status = 0;
+    comp->ElectricField(wire.x + wire.r + 1.e-4, wire.y, 0., ex, ey, ez, medium, status);
+    if (!medium || !medium->IonVelocity(ex, ey, ez, 0., 0., 0., vx, vy, vz)) {
+      G4Exception("WireSignalEngine::Build", "WireSignalEngine001", FatalException,
+                  ("no ion mobility in the gas around anode " + wire.label
+                   + ", set /gasModelParameters/heed/ionmobilityfile").c_str());
+    }
+  }
+
+  Garfield::AvalancheMC drift;
+  drift.SetSensor(&sensor);
+  drift.EnableSignalCalculation();
+  drift.SetDistanceSteps(2.e-4);
+
+  const size_t nCells = fAnodes.size()*fNAngles;
+  fResponse.assign(nCells, std::vector<std::vector<double>>(fElectrodes.size(), std::vector<double>(fNBins, 0.)));
+
+  // The ions of the avalanche leave the wire surface, their drift gives the signal
+  for (size_t w = 0; w < fAnodes.size(); w++) {
+    for (int a = 0; a < fNAngles; a++) {
+      double phi = twopi*(a + 0.5)/fNAngles;
+      double r = fAnodes[w].r + 1.e-4;
+      sensor.ClearSignal();
+      drift.DriftIon(fAnodes[w].x + r*std::cos(phi), fAnodes[w].y + r*std::sin(phi), 0., 0.);
+      for (size_t e = 0; e < fElectrodes.size(); e++)
+        for (int b = 0; b < fNBins; b++)
+          fResponse[Index(w, a)][e][b] = sensor.GetSignal(fElectrodes[e], b);
+    }
+  }
+
+  // Long windows are convolved in the frequency domain
+  fFFTSize = 0;
+  fSpectrum.clear();
+  if (fNBins >= 64) {
+    fFFTSize = radixfft::Size(2*(size_t)fNBins);
+    fSpectrum.assign(nCells, std::vector<std::vector<Complex>>(fElectrodes.size()));
+    for (size_t c = 0; c < nCells; c++) {
+      for (size_t e = 0; e < fElectrodes.size(); e++)
+        fSpectrum[c][e] = radixfft::Spectrum(fResponse[c][e], fFFTSize);
+    }
+  }
+
+  fArrivals.assign(nCells, std::vector<double>(fNBins, 0.));
+  fHit.assign(nCells, false);
+  fSamples.resize(fNBins);
+  fBuilt = true;
+
+  G4cout << "WireSignalEngine: " << fAnodes.size() << " anode wires x " << fNAngles << " positions, "
+         << fElectrodes.size() << " electrodes, " << fNBins << " bins of " << fBinWidth << " ns" << G4endl;
+}
+
+void WireSignalEngine::AddArrival(double x, double y, double t) {
+  if (!fBuilt) return;
+
+  int bin = (int)std::floor(t/fBinWidth);
+  if (bin < 0 || bin >= fNBins) return;
+
+  // Nearest anode wire, its periodic images included
+  const double tolerance = 5.e-3;  // cm
+  for (size_t w = 0; w < fAnodes.size(); w++) {
+    double dx = x - fAnodes[w].x;
+    if (fPeriod > 0.) dx -= fPeriod*std::round(dx/fPeriod);
+    double dy = y - fAnodes[w].y;
+    if (std::sqrt(dx*dx + dy*dy) > fAnodes[w].r + tolerance) continue;
+
+    double phi = std::atan2(dy, dx);
+    if (phi < 0.) phi += twopi;
+    int a = std::min(fNAngles - 1, (int)(phi/twopi*fNAngles));
+    fArrivals[Index(w, a)][bin] += fGain;
+    fHit[Index(w, a)] = true;
+    return;
+  }
+}
+
+void WireSignalEngine::ProcessEvent(G4int eventID) {
+  if (!fBuilt) return;
+
+  auto analysisManager = G4AnalysisManager::Instance();
+  const size_t nCells = fArrivals.size();
+
+  // Arrival spectra are shared by all electrodes
+  std::vector<std::vector<Complex>> arrivalSpectra;
+  if (fFFTSize) {
+    arrivalSpectra.resize(nCells);
+    for (size_t c = 0; c < nCells; c++) {
+      if (!fHit[c]) continue;
+      arrivalSpectra[c] = radixfft::Spectrum(fArrivals[c], fFFTSize);
+    }
+  }
+
+  for (size_t e = 0; e < fElectrodes.size(); e++) {
+    std::fill(fSamples.begin(), fSamples.end(), 0.);
+
+    if (fFFTSize) {
+      std::vector<Complex> sum(fFFTSize, 0.);
+      for (size_t c = 0; c < nCells; c++) {
+        if (!fHit[c]) continue;
+        for (size_t k = 0; k < fFFTSize; k++) sum[k] += arrivalSpectra[c][k]*fSpectrum[c][e][k];
+      }
+      radixfft::Transform(sum, true);
+      for (int b = 0; b < fNBins; b++) fSamples[b] = sum[b].real();
+    }
+    else {
+      for (size_t c = 0; c < nCells; c++)
+        if (fHit[c]) radixfft::AddDirectConvolution(fArrivals[c], fResponse[c][e], fSamples);
+    }
+
+    analysisManager->FillNtupleDColumn(0, 0, eventID);
+    analysisManager->FillNtupleSColumn(0, 1, fElectrodes[e]);
+    analysisManager->FillNtupleDColumn(0, 2, fBinWidth);
+    analysisManager->AddNtupleRow(0);
+  }
+
+  for (size_t c = 0; c < nCells; c++) {
+    if (!fHit[c]) continue;
+    std::fill(fArrivals[c].begin(), fArrivals[c].end(), 0.);
+    fHit[c] = false;
+  }
+}
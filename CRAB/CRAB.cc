@@ -11,6 +11,7 @@ https://svs.icts.kuleuven.be/projects/svs_project014/wiki/Wiki
 #include <ctime>
 #include <cstdio>
 #include <time.h>
+#include <memory>
 
 #include "G4RunManager.hh"
 #include "G4MTRunManager.hh"
@@ -26,6 +27,8 @@ https://svs.icts.kuleuven.be/projects/svs_project014/wiki/Wiki
 #include "PhysicsList.hh"
 #include "MyUserActionInitialization.hh"
 #include "GasModelParameters.hh"
+#include "SimulationServer.hh"
+#include "ScanDriver.hh"
 
 int main(int argc, char** argv) {
   G4Random::setTheEngine(new CLHEP::RanecuEngine);
@@ -42,12 +45,24 @@ int main(int argc, char** argv) {
 
   
   
-  G4int randseed = atoi(argv[2]);
+  // Server mode: CRAB --server <init.mac> <spooldir> <seed>
+  G4bool serverMode = (argc > 1 && G4String(argv[1]) == "--server");
+  if (serverMode && argc < 5) {
+    G4cout << "Usage: CRAB --server <init.mac> <spooldir> <seed>" << G4endl;
+    delete runManager;
+    return 0;
+  }
+
+  G4int randseed = (argc > 2) ? atoi(argv[serverMode ? 4 : 2]) : 0;
   G4Random::setTheSeed(randseed);
   G4cout << "Setting the Random seed: " << randseed << G4endl;
   
   G4cout << "Creation of the gas model parameter class" << G4endl;
   GasModelParameters* gmp = new GasModelParameters();
+
+  // In-process scans over pressure and fields (/Scan/...), the driver only
+  // has to outlive the UI session that uses its commands
+  std::unique_ptr<scan::ScanDriver> scanDriver(new scan::ScanDriver(gmp));
     
   G4cout << "Creation of DetectorConstruction" << G4endl;
   DetectorConstruction* detector = new DetectorConstruction(gmp);
@@ -84,6 +99,12 @@ int main(int argc, char** argv) {
 
     //#endif
 
+  } else if (serverMode) //! server mode: initialise once, then run spooled jobs
+  {
+    simserver::SimulationServer server(argv[3], randseed);
+    server.Initialise(argv[2]);
+    server.Serve();
+
   } else  //! batch mode:
   {
     auto start=std::chrono::high_resolution_clock::now();
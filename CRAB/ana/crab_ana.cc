@@ -0,0 +1,207 @@
+// crab_ana: summary histograms from many CRAB output files.
+//
+// Replaces the row-by-row loops of CalcYields.C, PlotCrab.C and crab-LEM.py.
+// The ntuples of all input files are read as one chain with RDataFrame, in
+// parallel over clusters of entries, so memory stays bounded by the number of
+// events rather than by the number of photon rows. All results of a chain are
+// booked first and filled in a single pass over it. The per-event histograms
+// have one entry for every event of the Event ntuple, zero when an event left
+// no photon.
+//
+// Usage: crab_ana [-j threads] [-o summary.root] [-n lem_norm] files...
+
+#include <ROOT/RDataFrame.hxx>
+#include <TChain.h>
+#include <TFile.h>
+#include <TH1D.h>
+#include <TH2D.h>
+#include <TROOT.h>
+
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    // Events of different files share their numbers, key them by (file, event)
+    using EventKey = std::pair<std::size_t, long>;
+    struct EventKeyHash {
+        std::size_t operator()(const EventKey& k) const {
+            return std::hash<std::size_t>()(k.first) ^ (std::hash<long>()(k.second) << 1);
+        }
+    };
+    using EventSums = std::unordered_map<EventKey, double, EventKeyHash>;
+    // One row of a per-event sum: the event and what the row adds
+    using EventRow = std::pair<EventKey, double>;
+
+    // PDG code written for optical photons, S1 and S2 alike (as counted by crab-LEM.py)
+    const double kPhotonPID = -22.;
+    const double kElectronPID = 11.;
+
+    std::unique_ptr<TChain> MakeChain(const std::string& tree, const std::vector<std::string>& files){
+        auto chain = std::make_unique<TChain>(tree.c_str());
+        for (const auto& f : files) chain->Add(f.c_str());
+        return chain;
+    }
+
+    // Per-file id so that events can be told apart across files
+    ROOT::RDF::RNode AddFileId(ROOT::RDataFrame& df){
+        return df.DefinePerSample("FileId", [](unsigned int, const ROOT::RDF::RSampleInfo& info){
+            return std::hash<std::string>()(info.AsString());
+        }).Define("Key", [](std::size_t file, double event){ return EventKey(file, (long)event); }, {"FileId", "Event"});
+    }
+
+    // Weighted rows per event, booked lazily so that it shares the event loop
+    // with the other results of the chain
+    ROOT::RDF::RResultPtr<EventSums> SumPerEvent(ROOT::RDF::RNode df, const std::string& weight, const std::string& name){
+        return df.Define(name, [](const EventKey& key, double w){ return EventRow(key, w); }, {"Key", weight})
+            .Aggregate([](EventSums& sums, const EventRow& row){ sums[row.first] += row.second; },
+                       [](std::vector<EventSums>& partial){
+                           for (std::size_t i = 1; i < partial.size(); i++)
+                               for (const auto& e : partial[i]) partial[0][e.first] += e.second;
+                       }, name, EventSums());
+    }
+
+    // One entry per event of the Event ntuple, so that events without any row
+    // count as zero. Without an Event ntuple only the events in sums are known.
+    TH1D* YieldHistogram(const EventSums& sums, const std::vector<EventKey>& events, const char* name, const char* title){
+        double max = 1.;
+        for (const auto& e : sums) max = std::max(max, e.second);
+        TH1D* h = new TH1D(name, title, 200, 0., 1.05*max);
+        if (events.empty()){
+            for (const auto& e : sums) h->Fill(e.second);
+            return h;
+        }
+        for (const auto& k : events){
+            auto e = sums.find(k);
+            h->Fill(e != sums.end() ? e->second : 0.);
+        }
+        return h;
+    }
+}
+
+int main(int argc, char** argv){
+
+    unsigned int nThreads = 0;
+    std::string output = "crab_summary.root";
+    double lemNorm = 1.;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc)      nThreads = std::stoi(argv[++i]);
+        else if (arg == "-o" && i + 1 < argc) output = argv[++i];
+        else if (arg == "-n" && i + 1 < argc) lemNorm = std::stod(argv[++i]);
+        else files.push_back(arg);
+    }
+
+    if (files.empty()){
+        std::cerr << "Usage: crab_ana [-j threads] [-o summary.root] [-n lem_norm] files..." << std::endl;
+        return 1;
+    }
+
+    ROOT::EnableImplicitMT(nThreads);
+    const unsigned int nSlots = ROOT::GetThreadPoolSize() > 0 ? ROOT::GetThreadPoolSize() : 1;
+    std::cout << "crab_ana: " << files.size() << " files, " << nSlots << " threads" << std::endl;
+
+    TFile out(output.c_str(), "RECREATE");
+
+    // Every simulated event, with or without photons
+    std::vector<EventKey> events;
+    auto evChain = MakeChain("ntuple/Event", files);
+    if (evChain->GetEntries() > 0){
+        ROOT::RDataFrame evDF(*evChain);
+        events = *AddFileId(evDF).Take<EventKey>("Key");
+        std::cout << "crab_ana: " << events.size() << " events" << std::endl;
+    }
+    else
+        std::cout << "crab_ana: no Event ntuple, events without photons are not counted" << std::endl;
+
+    // Camera: light yield per event, image, boundary of the last reflection
+    auto camChain = MakeChain("ntuple/Camera", files);
+    if (camChain->GetEntries() > 0){
+        ROOT::RDataFrame camDF(*camChain);
+        auto cam = AddFileId(camDF);
+        // Files written before the weight window have no Weight column
+        if (!cam.HasColumn("Weight")) cam = cam.Define("Weight", [](){ return 1.; });
+
+        auto image = cam.Histo2D({"hCameraXY", "Camera X vs Y; X [mm]; Y [mm]", 200, -12.7, 12.7, 200, -12.7, 12.7}, "X", "Y", "Weight");
+        auto time  = cam.Histo1D({"hCameraTime", "Camera time; Time [ns]; Photons", 500, 0., 0.}, "Time", "Weight");
+
+        using Boundaries = std::map<std::string, double>;
+        auto boundaries = cam.Define("BoundaryRow", [](const std::string& b, double w){ return std::make_pair(b, w); }, {"Boundary", "Weight"})
+            .Aggregate([](Boundaries& m, const std::pair<std::string, double>& row){ m[row.first] += row.second; },
+                       [](std::vector<Boundaries>& partial){
+                           for (std::size_t i = 1; i < partial.size(); i++)
+                               for (const auto& e : partial[i]) partial[0][e.first] += e.second;
+                       }, "BoundaryRow", Boundaries());
+
+        auto yields = SumPerEvent(cam, "Weight", "CameraRow");
+
+        // The first result read runs the single loop over the chain
+        out.cd();
+        YieldHistogram(*yields, events, "hCameraLY", "Camera LY; Photons per event; Events")->Write();
+        image->Write();
+        time->Write();
+
+        TH1D hBoundary("hCameraBoundary", "Camera photons by reflecting boundary; ; Photons", boundaries->size(), 0, boundaries->size());
+        int bin = 1;
+        for (const auto& e : *boundaries){
+            hBoundary.GetXaxis()->SetBinLabel(bin, e.first.c_str());
+            hBoundary.SetBinContent(bin++, e.second);
+        }
+        hBoundary.Write();
+
+        std::cout << "crab_ana: camera photons in " << yields->size() << " events" << std::endl;
+    }
+
+    // PMT: light yield per event and time spectrum
+    auto pmtChain = MakeChain("ntuple/PMT", files);
+    if (pmtChain->GetEntries() > 0){
+        ROOT::RDataFrame pmtDF(*pmtChain);
+        auto pmt = AddFileId(pmtDF);
+        if (!pmt.HasColumn("Weight")) pmt = pmt.Define("Weight", [](){ return 1.; });
+
+        auto time = pmt.Histo1D({"hPMTTime", "PMT time; Time [ns]; Photons", 1000, 0., 0.}, "Time", "Weight");
+        auto yields = SumPerEvent(pmt, "Weight", "PMTRow");
+
+        out.cd();
+        YieldHistogram(*yields, events, "hPMTLY", "PMT LY; Photons per event; Events")->Write();
+        time->Write();
+
+        std::cout << "crab_ana: PMT photons in " << yields->size() << " events" << std::endl;
+    }
+
+    // S2: EL photons per electron (LEM gain), normalised like crab-LEM.py.
+    // Rows of other particles are not counted.
+    auto s2Chain = MakeChain("ntuple/S2", files);
+    if (s2Chain->GetEntries() > 0){
+        ROOT::RDataFrame s2DF(*s2Chain);
+        auto s2 = AddFileId(s2DF)
+            .Define("IsPhoton", [](double pid){ return pid == kPhotonPID ? 1. : 0.; }, {"PID"})
+            .Define("IsElectron", [](double pid){ return pid == kElectronPID ? 1. : 0.; }, {"PID"});
+
+        auto photons   = SumPerEvent(s2, "IsPhoton", "PhotonRow");
+        auto electrons = SumPerEvent(s2, "IsElectron", "ElectronRow");
+
+        EventSums gain;
+        for (const auto& e : *photons){
+            auto n = electrons->find(e.first);
+            gain[e.first] = (n != electrons->end() && n->second > 0.) ? e.second/n->second : e.second/lemNorm;
+        }
+
+        out.cd();
+        YieldHistogram(gain, events, "hLEMGain", "LEM gain; EL photons per electron; Events")->Write();
+
+        std::cout << "crab_ana: S2 rows in " << gain.size() << " events" << std::endl;
+    }
+
+    out.Close();
+    std::cout << "crab_ana: wrote " << output << std::endl;
+
+    return 0;
+}
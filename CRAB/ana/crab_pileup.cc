@@ -0,0 +1,313 @@
+// crab_pileup: pile-up events synthesised from simulated single interactions.
+//
+// The Camera, PMT and Image ntuples of previous runs are used as a library of
+// single interactions. Each output event is a readout window in which the
+// interactions arrive as a Poisson process at the given source rate: their
+// photons are shifted by the arrival time, kept if they fall in the window,
+// and PMT and camera dark counts are added. The output has the ntuples of a
+// normal run, so crab_ana and the plotting macros read it unchanged, plus a
+// Pileup ntuple listing the interactions of every event.
+//
+// Camera images carry no time, they are summed for the interactions that
+// arrive inside the window.
+//
+// Usage: crab_pileup -r rate_Hz [-w window_ns] [-p pre_ns] [-n events]
+//                    [-d pmt_dark_Hz] [-c camera_dark_Hz] [-R camera_r_mm]
+//                    [-s seed] [-o pileup.root] files...
+
+#include <ROOT/RDataFrame.hxx>
+#include <TChain.h>
+#include <TFile.h>
+#include <TRandom3.h>
+#include <TTree.h>
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    // One row of the Camera or PMT ntuple
+    struct PhotonRow {
+        double pid, time, x, y, z;
+        int reflected;
+        std::string boundary;
+        int sid;
+        double weight;
+    };
+
+    struct PixelRow {
+        int ix, iy;
+        double x, y, counts;
+    };
+
+    // Everything one simulated interaction left in the readout
+    struct Interaction {
+        std::vector<PhotonRow> camera;
+        std::vector<PhotonRow> pmt;
+        std::vector<PixelRow> image;
+        double pke = 0., edep = 0.;
+    };
+
+    using Key = std::pair<std::size_t, long>;
+    using Library = std::map<Key, Interaction>;
+
+    std::unique_ptr<TChain> MakeChain(const std::string& tree, const std::vector<std::string>& files){
+        auto chain = std::make_unique<TChain>(tree.c_str());
+        for (const auto& f : files) chain->Add(f.c_str());
+        return chain;
+    }
+
+    ROOT::RDF::RNode AddFileId(ROOT::RDataFrame& df){
+        return df.DefinePerSample("FileId", [](unsigned int, const ROOT::RDF::RSampleInfo& info){
+            return std::hash<std::string>()(info.AsString());
+        });
+    }
+
+    void LoadPhotons(const std::string& tree, const std::vector<std::string>& files, Library& library,
+                     std::vector<PhotonRow> Interaction::* member){
+        auto chain = MakeChain(tree, files);
+        if (chain->GetEntries() == 0) return;
+        ROOT::RDataFrame df(*chain);
+        auto rows = AddFileId(df);
+        if (!rows.HasColumn("Weight")) rows = rows.Define("Weight", [](){ return 1.; });
+
+        rows.Foreach([&library, member](std::size_t file, double event, double pid, double time,
+                                        double x, double y, double z, int reflected,
+                                        const std::string& boundary, int sid, double weight){
+            (library[{file, (long)event}].*member).push_back({pid, time, x, y, z, reflected, boundary, sid, weight});
+        }, {"FileId", "Event", "PID", "Time", "X", "Y", "Z", "Reflected", "Boundary", "SID", "Weight"});
+    }
+
+    // Writes rows in the layout of the Geant4 ntuples
+    class PhotonTree {
+        public:
+            PhotonTree(const char* name, const char* title) : tree_(name, title) {
+                tree_.Branch("Event", &event_, "Event/D");
+                tree_.Branch("PID", &row_.pid, "PID/D");
+                tree_.Branch("Time", &row_.time, "Time/D");
+                tree_.Branch("X", &row_.x, "X/D");
+                tree_.Branch("Y", &row_.y, "Y/D");
+                tree_.Branch("Z", &row_.z, "Z/D");
+                tree_.Branch("Reflected", &row_.reflected, "Reflected/I");
+                tree_.Branch("Boundary", boundary_, "Boundary/C");
+                tree_.Branch("SID", &row_.sid, "SID/I");
+                tree_.Branch("Weight", &row_.weight, "Weight/D");
+            }
+            void Fill(double event, const PhotonRow& row){
+                event_ = event;
+                row_ = row;
+                std::strncpy(boundary_, row.boundary.c_str(), sizeof(boundary_) - 1);
+                boundary_[sizeof(boundary_) - 1] = '\0';
+                tree_.Fill();
+            }
+            void Write(){ tree_.Write(); }
+        private:
+            TTree tree_;
+            double event_;
+            PhotonRow row_;
+            char boundary_[256];
+    };
+}
+
+int main(int argc, char** argv){
+
+    double rate = -1.;          // Hz
+    double window = 1e6;        // ns
+    double pre = -1.;           // ns before the window, defaults to the window
+    long nEvents = 1000;
+    double pmtDark = 0.;        // Hz per PMT
+    double cameraDark = 0.;     // Hz over the camera
+    double cameraR = 12.7;      // mm
+    unsigned int seed = 4357;
+    std::string output = "crab_pileup.root";
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if (arg == "-r" && i + 1 < argc)      rate = std::stod(argv[++i]);
+        else if (arg == "-w" && i + 1 < argc) window = std::stod(argv[++i]);
+        else if (arg == "-p" && i + 1 < argc) pre = std::stod(argv[++i]);
+        else if (arg == "-n" && i + 1 < argc) nEvents = std::stol(argv[++i]);
+        else if (arg == "-d" && i + 1 < argc) pmtDark = std::stod(argv[++i]);
+        else if (arg == "-c" && i + 1 < argc) cameraDark = std::stod(argv[++i]);
+        else if (arg == "-R" && i + 1 < argc) cameraR = std::stod(argv[++i]);
+        else if (arg == "-s" && i + 1 < argc) seed = std::stoul(argv[++i]);
+        else if (arg == "-o" && i + 1 < argc) output = argv[++i];
+        else files.push_back(arg);
+    }
+
+    if (files.empty() || rate < 0.){
+        std::cerr << "Usage: crab_pileup -r rate_Hz [-w window_ns] [-p pre_ns] [-n events] [-d pmt_dark_Hz]"
+                  << " [-c camera_dark_Hz] [-R camera_r_mm] [-s seed] [-o pileup.root] files..." << std::endl;
+        return 1;
+    }
+    if (pre < 0.) pre = window;
+
+    // Library of single interactions. Events without any photon count too,
+    // so every event of the Event ntuple is an entry.
+    Library library;
+    {
+        auto chain = MakeChain("ntuple/Event", files);
+        if (chain->GetEntries() > 0){
+            ROOT::RDataFrame df(*chain);
+            AddFileId(df).Foreach([&library](std::size_t file, double event, double pke, double edep){
+                Interaction& i = library[{file, (long)event}];
+                i.pke = pke;
+                i.edep = edep;
+            }, {"FileId", "Event", "PKE", "PEDep"});
+        }
+    }
+    LoadPhotons("ntuple/Camera", files, library, &Interaction::camera);
+    LoadPhotons("ntuple/PMT", files, library, &Interaction::pmt);
+    {
+        auto chain = MakeChain("ntuple/Image", files);
+        if (chain->GetEntries() > 0){
+            ROOT::RDataFrame df(*chain);
+            AddFileId(df).Foreach([&library](std::size_t file, double event, int ix, int iy,
+                                             double x, double y, double counts){
+                library[{file, (long)event}].image.push_back({ix, iy, x, y, counts});
+            }, {"FileId", "Event", "IX", "IY", "X", "Y", "Counts"});
+        }
+    }
+
+    if (library.empty()){
+        std::cerr << "crab_pileup: no simulated events in the input files" << std::endl;
+        return 1;
+    }
+
+    std::vector<const Interaction*> singles;
+    std::vector<Key> keys;
+    std::set<int> pmtIDs;
+    for (const auto& e : library){
+        singles.push_back(&e.second);
+        keys.push_back(e.first);
+        for (const auto& p : e.second.pmt) pmtIDs.insert(p.sid);
+    }
+    std::cout << "crab_pileup: " << singles.size() << " single interactions, "
+              << rate*(window + pre)*1e-9 << " interactions per event on average" << std::endl;
+
+    TRandom3 random(seed);
+
+    TFile out(output.c_str(), "RECREATE");
+    out.mkdir("ntuple")->cd();
+
+    PhotonTree camera("Camera", "Camera Hits");
+    PhotonTree pmt("PMT", "PMT Hits");
+
+    TTree image("Image", "Camera image of the lens model");
+    double imEvent, imX, imY, imCounts;
+    int imIX, imIY;
+    image.Branch("Event", &imEvent, "Event/D");
+    image.Branch("IX", &imIX, "IX/I");
+    image.Branch("IY", &imIY, "IY/I");
+    image.Branch("X", &imX, "X/D");
+    image.Branch("Y", &imY, "Y/D");
+    image.Branch("Counts", &imCounts, "Counts/D");
+
+    TTree eventTree("Event", "Event stats");
+    double evEvent, evPPID, evPKE, evEDep;
+    eventTree.Branch("Event", &evEvent, "Event/D");
+    eventTree.Branch("PPID", &evPPID, "PPID/D");
+    eventTree.Branch("PKE", &evPKE, "PKE/D");
+    eventTree.Branch("PEDep", &evEDep, "PEDep/D");
+
+    TTree pileup("Pileup", "Interactions of every pile-up event");
+    double puEvent, puOffset, puSource;
+    int puIndex, puFile;
+    pileup.Branch("Event", &puEvent, "Event/D");
+    pileup.Branch("Interaction", &puIndex, "Interaction/I");
+    pileup.Branch("File", &puFile, "File/I");
+    pileup.Branch("SourceEvent", &puSource, "SourceEvent/D");
+    pileup.Branch("Offset", &puOffset, "Offset/D");
+
+    std::map<std::size_t, int> fileIndex;
+    for (const auto& k : keys) fileIndex.emplace(k.first, fileIndex.size());
+
+    const double span = window + pre;
+    const double meanInteractions = rate*span*1e-9;
+    long totalInteractions = 0;
+
+    for (long ev = 0; ev < nEvents; ev++){
+        evEvent = ev;
+        evPPID = 0.;
+        evPKE = 0.;
+        evEDep = 0.;
+
+        std::map<std::pair<int, int>, PixelRow> pixels;
+
+        int n = random.Poisson(meanInteractions);
+        totalInteractions += n;
+        for (int i = 0; i < n; i++){
+            // Arrival times of a Poisson process are uniform given their number
+            double offset = random.Uniform(-pre, window);
+            std::size_t pick = random.Integer(singles.size());
+            const Interaction& single = *singles[pick];
+
+            for (PhotonRow row : single.camera){
+                row.time += offset;
+                if (row.time >= 0. && row.time < window) camera.Fill(ev, row);
+            }
+            for (PhotonRow row : single.pmt){
+                row.time += offset;
+                if (row.time >= 0. && row.time < window) pmt.Fill(ev, row);
+            }
+            if (offset >= 0.){
+                for (const auto& px : single.image){
+                    auto it = pixels.emplace(std::make_pair(px.ix, px.iy), px);
+                    if (!it.second) it.first->second.counts += px.counts;
+                }
+                evPKE += single.pke;
+                evEDep += single.edep;
+            }
+
+            puEvent = ev;
+            puIndex = i;
+            puFile = fileIndex[keys[pick].first];
+            puSource = keys[pick].second;
+            puOffset = offset;
+            pileup.Fill();
+        }
+
+        // Dark counts, flagged by their boundary
+        for (int sid : pmtIDs){
+            int nDark = random.Poisson(pmtDark*window*1e-9);
+            for (int d = 0; d < nDark; d++)
+                pmt.Fill(ev, {0., random.Uniform(0., window), 0., 0., 0., 0, "DarkCount", sid, 1.});
+        }
+        int nDark = random.Poisson(cameraDark*window*1e-9);
+        for (int d = 0; d < nDark; d++){
+            double r = cameraR*std::sqrt(random.Uniform());
+            double phi = random.Uniform(0., 2.*M_PI);
+            camera.Fill(ev, {0., random.Uniform(0., window), r*std::cos(phi), r*std::sin(phi), 0., 0, "DarkCount", 0, 1.});
+        }
+
+        imEvent = ev;
+        for (const auto& px : pixels){
+            imIX = px.second.ix;
+            imIY = px.second.iy;
+            imX = px.second.x;
+            imY = px.second.y;
+            imCounts = px.second.counts;
+            image.Fill();
+        }
+        eventTree.Fill();
+    }
+
+    camera.Write();
+    pmt.Write();
+    image.Write();
+    eventTree.Write();
+    pileup.Write();
+    out.Close();
+
+    std::cout << "crab_pileup: wrote " << nEvents << " events with " << totalInteractions
+              << " interactions to " << output << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+// trigger_bench: ModelTrigger decisions per second, string compares against
+// the pointer tables of FastSimTrigger.hh.
+//
+// The step stream mimics a typical CRAB event: mostly optical photons from the
+// EL region, some ionisation electrons and a few photo/Compton electrons. For
+// every step the particle test of GarfieldVUVPhotonModel and the particle and
+// creator process test of DegradModel are evaluated.
+//
+// Usage: crab_trigger_bench [steps]
+
+#include "FastSimTrigger.hh"
+
+#include "G4ComptonScattering.hh"
+#include "G4Electron.hh"
+#include "G4Gamma.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4PhotoElectricEffect.hh"
+#include "G4eIonisation.hh"
+#include "Randomize.hh"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    struct Step {
+        const G4ParticleDefinition* particle;
+        const G4VProcess* creator;
+    };
+
+    G4bool StringTrigger(const Step& s){
+        G4bool garfield = s.particle->GetParticleName() == "e-";
+        G4bool degrad = s.particle->GetParticleName() == "e-" &&
+            (s.creator->GetProcessName().find("phot") != std::string::npos ||
+             s.creator->GetProcessName().find("comp") != std::string::npos);
+        return garfield || degrad;
+    }
+
+    template <class F>
+    double Rate(const std::vector<Step>& steps, long n, F trigger, long& accepted){
+        accepted = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (long i = 0; i < n; i++)
+            accepted += trigger(steps[i % steps.size()]);
+        auto end = std::chrono::high_resolution_clock::now();
+        return n/std::chrono::duration<double>(end - start).count();
+    }
+}
+
+int main(int argc, char** argv){
+
+    long n = argc > 1 ? std::stol(argv[1]) : 100000000;
+
+    const G4ParticleDefinition* photon = G4OpticalPhoton::Definition();
+    const G4ParticleDefinition* gamma = G4Gamma::Definition();
+    const G4ParticleDefinition* electron = G4Electron::Definition();
+
+    G4PhotoElectricEffect phot;
+    G4ComptonScattering compt;
+    G4eIonisation eIoni;
+
+    // 95 % optical photons, 4.5 % ionisation electrons, 0.5 % photo/Compton
+    // electrons and gammas; thermal electrons are represented by e-
+    std::vector<Step> steps;
+    for (int i = 0; i < 10000; i++){
+        double r = G4UniformRand();
+        if (r < 0.95)        steps.push_back({photon, &eIoni});
+        else if (r < 0.995)  steps.push_back({electron, &eIoni});
+        else if (r < 0.9975) steps.push_back({electron, G4UniformRand() < 0.5 ? (G4VProcess*)&phot : &compt});
+        else                 steps.push_back({gamma, &compt});
+    }
+
+    fastsimtrigger::ParticleTrigger garfieldParticle {fastsimtrigger::ParticleNames{{"e-"}}};
+    fastsimtrigger::ParticleTrigger degradParticle {fastsimtrigger::ParticleNames{{"e-"}}};
+    fastsimtrigger::CreatorTrigger degradCreator {fastsimtrigger::ProcessNameFragments{{"phot", "comp"}}};
+
+    long acceptedString, acceptedPointer;
+    double stringRate = Rate(steps, n, StringTrigger, acceptedString);
+    double pointerRate = Rate(steps, n, [&](const Step& s){
+        G4bool garfield = garfieldParticle(s.particle);
+        G4bool degrad = degradParticle(s.particle) && degradCreator(s.creator);
+        return garfield || degrad;
+    }, acceptedPointer);
+
+    if (acceptedString != acceptedPointer){
+        std::cerr << "trigger_bench: decisions differ" << std::endl;
+        return 1;
+    }
+
+    std::cout << "trigger_bench: " << n << " steps, " << acceptedPointer << " triggered" << std::endl;
+    std::cout << "  string compares: " << stringRate/1e6 << " M ModelTrigger/s" << std::endl;
+    std::cout << "  pointer tables:  " << pointerRate/1e6 << " M ModelTrigger/s ("
+              << pointerRate/stringRate << "x)" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+#!/usr/bin/env python
+# Convert a CSV of primaries into a binary event library for the generator
+# (/Generator/SingleParticle/Mode Library).
+#
+# Input rows: event,pdg,energy[keV],dx,dy,dz,x[mm],y[mm],z[mm],time[ns]
+# Rows of one event must be consecutive, the event numbers themselves are not
+# stored: the n-th event of the file is simulated as event n (after skip).
+#
+# Usage: python convertEventLibrary.py input.csv output.bin
+import csv
+import struct
+import sys
+
+
+def write_event(out, primaries):
+    out.write(struct.pack("<i", len(primaries)))
+    for p in primaries:
+        out.write(struct.pack("<i8f", *p))
+
+
+if len(sys.argv) != 3:
+    print("Usage: python convertEventLibrary.py input.csv output.bin")
+    sys.exit(1)
+
+nEvents = 0
+with open(sys.argv[1]) as infile, open(sys.argv[2], "wb") as out:
+    out.write(b"CRABLIB1")
+    current = None
+    primaries = []
+    for row in csv.reader(infile):
+        if not row or row[0].startswith("#"):
+            continue
+        try:
+            event = int(float(row[0]))
+        except ValueError:
+            continue  # header line
+        if current is not None and event != current:
+            write_event(out, primaries)
+            nEvents += 1
+            primaries = []
+        current = event
+        primaries.append([int(float(row[1]))] + [float(v) for v in row[2:10]])
+    if primaries:
+        write_event(out, primaries)
+        nEvents += 1
+
+print("Wrote %d events to %s" % (nEvents, sys.argv[2]))
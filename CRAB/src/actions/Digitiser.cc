@@ -0,0 +1,122 @@
+#include "Digitiser.hh"
+
+#include "G4Event.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4SDManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+
+#include "SensorHit.hh"
+#include "Analysis.hh"
+
+Digitiser::Digitiser() :
+  enabled_(false), samplingPeriod_(4.*ns), nSamples_(4096), startTime_(0.),
+  gain_(100.), gainSigma_(0.3), tts_(0.*ns), riseTime_(1.*ns), fallTime_(5.*ns),
+  noise_(1.), baseline_(0.) {
+
+  msg_ = new G4GenericMessenger(this, "/Digitiser/", "PMT waveform digitisation.");
+
+  msg_->DeclareProperty("enable", enabled_, "Write a sampled waveform per PMT and event");
+  msg_->DeclarePropertyWithUnit("samplingPeriod", "ns", samplingPeriod_, "Sampling period");
+  msg_->DeclareProperty("nSamples", nSamples_, "Samples per waveform");
+  msg_->DeclarePropertyWithUnit("startTime", "ns", startTime_, "Time of the first sample");
+  msg_->DeclareProperty("gain", gain_, "Integrated ADC counts of a single photoelectron");
+  msg_->DeclareProperty("gainSigma", gainSigma_, "Relative gain spread of a single photoelectron");
+  msg_->DeclarePropertyWithUnit("transitTimeSpread", "ns", tts_, "Transit time spread (sigma)");
+  msg_->DeclarePropertyWithUnit("riseTime", "ns", riseTime_, "Rise time of the SPE pulse");
+  msg_->DeclarePropertyWithUnit("fallTime", "ns", fallTime_, "Fall time of the SPE pulse");
+  msg_->DeclareProperty("noise", noise_, "Gaussian noise per sample in ADC counts");
+  msg_->DeclareProperty("baseline", baseline_, "Baseline in ADC counts");
+}
+
+Digitiser::~Digitiser() {
+  delete msg_;
+}
+
+void Digitiser::UpdateTemplate(size_t fftSize) {
+  std::vector<G4double> key {(G4double)fftSize, samplingPeriod_, gain_, riseTime_, fallTime_};
+  if (key == templateKey_) return;
+  templateKey_ = key;
+
+  // Difference of exponentials, sampled and normalised to the gain
+  std::vector<Complex> pulse(fftSize, 0.);
+  G4double sum = 0.;
+  size_t length = std::min(fftSize, (size_t)std::ceil(10.*fallTime_/samplingPeriod_) + 1);
+  for (size_t i = 0; i < length; i++){
+    G4double t = i*samplingPeriod_;
+    G4double v = std::exp(-t/fallTime_) - (riseTime_ > 0. ? std::exp(-t/riseTime_) : 0.);
+    pulse[i] = v;
+    sum += v;
+  }
+  if (sum > 0.)
+    for (size_t i = 0; i < length; i++) pulse[i] *= gain_/sum;
+
+  radixfft::Transform(pulse, false);
+  templateSpectrum_ = pulse;
+}
+
+void Digitiser::Digitise(const G4Event* event) {
+  if (!enabled_) return;
+
+  G4HCofThisEvent* hce = event->GetHCofThisEvent();
+  if (!hce) return;
+
+  // Photons up to one pulse length before the window still add their tails,
+  // they are kept in the first samples of the signal. The pulse tail must not
+  // wrap around into the start of the waveform.
+  size_t tail = (size_t)std::ceil(10.*fallTime_/samplingPeriod_) + 1;
+  size_t nBins = (size_t)nSamples_ + tail;
+  size_t fftSize = radixfft::Size(nBins + tail);
+  UpdateTemplate(fftSize);
+
+  G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+  G4int id = 7;
+
+  std::vector<Complex> signal(fftSize);
+
+  for (G4int i = 0; i < hce->GetNumberOfCollections(); i++){
+    auto collection = dynamic_cast<SensorHitsCollection*>(hce->GetHC(i));
+    if (!collection) continue;
+
+    for (size_t h = 0; h < collection->entries(); h++){
+      const sensorhit::SensorHit* hit = (*collection)[h];
+
+      // Photoelectrons per sample
+      std::vector<G4double> pe(nBins, 0.);
+      for (const auto& photon : hit->GetPhotons()){
+        G4double t = photon.first;
+        if (tts_ > 0.) t += G4RandGauss::shoot(0., tts_);
+        G4long bin = (G4long)std::floor((t - startTime_)/samplingPeriod_) + (G4long)tail;
+        if (bin >= 0 && bin < (G4long)nBins) pe[bin] += photon.second;
+      }
+
+      // Sum of n single photoelectron gains, in units of the mean gain
+      std::fill(signal.begin(), signal.end(), Complex(0.));
+      for (size_t s = 0; s < nBins; s++){
+        if (pe[s] <= 0.) continue;
+        G4double charge = pe[s];
+        if (gainSigma_ > 0.)
+          charge = std::max(0., G4RandGauss::shoot(pe[s], gainSigma_*std::sqrt(pe[s])));
+        signal[s] = charge;
+      }
+
+      radixfft::Transform(signal, false);
+      for (size_t k = 0; k < fftSize; k++) signal[k] *= templateSpectrum_[k];
+      radixfft::Transform(signal, true);
+
+      samples_.resize(nSamples_);
+      for (G4int s = 0; s < nSamples_; s++){
+        G4double v = baseline_ + signal[s + tail].real();
+        if (noise_ > 0.) v += G4RandGauss::shoot(0., noise_);
+        samples_[s] = v;
+      }
+
+      analysisManager->FillNtupleDColumn(id,0, event->GetEventID());
+      analysisManager->FillNtupleIColumn(id,1, hit->GetPmtID());
+      analysisManager->FillNtupleDColumn(id,2, startTime_/ns);
+      analysisManager->FillNtupleDColumn(id,3, samplingPeriod_/ns);
+      analysisManager->AddNtupleRow(id);
+    }
+  }
+}
@@ -0,0 +1,59 @@
+#ifndef Digitiser_hh
+#define Digitiser_hh 1
+
+#include "G4Types.hh"
+#include "G4GenericMessenger.hh"
+#include "RadixFFT.hh"
+
+#include <vector>
+
+class G4Event;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Turns the photoelectrons registered by the PMT sensitive detectors into
+// sampled waveforms. Photoelectrons (the QE of the photocathode is applied by
+// its EFFICIENCY surface property) are smeared by the transit time spread and
+// histogrammed at the sampling period, the gain fluctuations are drawn per
+// sample, and the result is convolved with the SPE pulse by FFT so the cost
+// does not depend on the number of photoelectrons. Noise is added per sample.
+class Digitiser {
+ public:
+  Digitiser();
+  ~Digitiser();
+
+  // Fill one row of the Waveform ntuple per sensor with hits
+  void Digitise(const G4Event*);
+
+  inline G4bool IsEnabled() const {return enabled_;};
+  inline std::vector<G4double>& GetSamples() {return samples_;};
+
+ private:
+  typedef radixfft::Complex Complex;
+
+  // Spectrum of the SPE pulse for the current settings and FFT size
+  void UpdateTemplate(size_t fftSize);
+
+  G4GenericMessenger* msg_;
+  G4bool enabled_;
+  G4double samplingPeriod_;
+  G4int nSamples_;
+  G4double startTime_;
+  G4double gain_;       // ADC counts integrated over one SPE pulse
+  G4double gainSigma_;  // relative single photoelectron gain spread
+  G4double tts_;        // transit time spread (sigma)
+  G4double riseTime_;
+  G4double fallTime_;
+  G4double noise_;      // ADC counts per sample
+  G4double baseline_;
+
+  // Cached template spectrum and the settings it was made with
+  std::vector<Complex> templateSpectrum_;
+  std::vector<G4double> templateKey_;
+
+  std::vector<G4double> samples_; // row buffer of the Waveform ntuple
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -14,12 +14,33 @@
 #include "G4GlobalFastSimulationManager.hh"
 #include "DegradModel.hh"
 #include "GarfieldVUVPhotonModel.hh"
-
-EventAction::EventAction() {
-  
+#include "LensCameraModel.hh"
+#include "OpticalWeightWindow.hh"
+#include "ReadoutGate.hh"
+#include "Digitiser.hh"
+#include "PrimaryGenerator.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4SystemOfUnits.hh"
+
+EventAction::EventAction(RunAction* run) : stopMsg_(nullptr),
+  fStopEnabled(false), fStopObservable("camera"), fStopPrecision(0.01), fStopMinEvents(10),
+  fStopWallTime(0.), fRunStart(std::chrono::steady_clock::now()),
+  fRunAction(run), fWeightWindow(nullptr), fReadoutGate(nullptr),
+  fEDepPrim(0.), fCameraYield(0.), fPMTYield(0.) {
+
+  stopMsg_ = new G4GenericMessenger(this, "/Action/StopCondition/",
+    "Stop the run once an observable is known to a given precision.");
+
+  stopMsg_->DeclareProperty("enable", fStopEnabled, "Stop the run on the precision or wall time condition");
+  stopMsg_->DeclareProperty("observable", fStopObservable, "camera, pmt (photons per event), edep or yield (camera photons per MeV)");
+  stopMsg_->DeclareProperty("precision", fStopPrecision, "Relative error of the mean to reach");
+  stopMsg_->DeclareProperty("minEvents", fStopMinEvents, "Events before the condition is checked");
+  stopMsg_->DeclarePropertyWithUnit("wallTime", "s", fStopWallTime, "Stop after this wall time, 0 for no limit");
 }
 
 EventAction::~EventAction() {
+	delete stopMsg_;
 	G4cout << "Deleting EventAction" << G4endl;
 }
 
@@ -39,6 +60,8 @@ void EventAction::BeginOfEventAction(const G4Event *ev) {
       }
 
     fEDepPrim = 0.0;
+    fCameraYield = 0.0;
+    fPMTYield = 0.0;
     G4cout << " EventAction::BeginOfEventAction()  1 " << G4endl;
 }
 
@@ -48,6 +71,12 @@ void EventAction::EndOfEventAction(const G4Event *evt) {
     if(gvm)
       gvm->Reset(); // zero out the sensor: meaning reset the nexcitations, which is cumulative.
 
+    LensCameraModel* lcm = (LensCameraModel*)(G4GlobalFastSimulationManager::GetInstance()->GetFastSimulationModel("LensCameraModel"));
+    if(lcm){
+      lcm->FillImage(evt->GetEventID());
+      lcm->Reset();
+    }
+
     G4cout << " EventAction::EndOfEventAction()  " << G4endl;
 
 
@@ -60,6 +89,10 @@ void EventAction::EndOfEventAction(const G4Event *evt) {
 	PKE = pVtx->GetPrimary(0)->GetKineticEnergy();
 	PPID = pVtx->GetPrimary(0)->GetPDGcode();
       }
+    // Injected clusters: the ionisation energy, not that of a thermal electron
+    ClusterInformation* cluster = dynamic_cast<ClusterInformation*>(evt->GetUserInformation());
+    if (cluster)
+      PKE = cluster->GetEnergy();
 
     G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
     G4int  event = evt->GetEventID();
@@ -70,6 +103,38 @@ void EventAction::EndOfEventAction(const G4Event *evt) {
     analysisManager->FillNtupleDColumn(id,row, fEDepPrim); row++;
     analysisManager->AddNtupleRow(id);
 
+    if (fRunAction){
+      G4int killed = 0, survived = 0;
+      if (fWeightWindow){
+        killed = fWeightWindow->GetKilled();
+        survived = fWeightWindow->GetSurvived();
+        fWeightWindow->ResetCounters();
+      }
+      fRunAction->AddEvent(fCameraYield, fPMTYield, killed, survived);
+
+      G4int culled = 0, culledElectrons = 0;
+      G4double culledTime = 0.;
+      if (fReadoutGate){
+        culled = fReadoutGate->GetCulled();
+        culledTime = fReadoutGate->GetCulledTime();
+        fReadoutGate->ResetCounters();
+      }
+      if (gvm)
+        culledElectrons = gvm->TakeCulledElectrons();
+      fRunAction->AddCulled(culled, culledTime, culledElectrons);
+
+      if (gvm){
+        G4int electrons = 0, stalled = 0;
+        G4double steps = 0., fixedSteps = 0.;
+        gvm->TakeDriftSteps(electrons, steps, fixedSteps, stalled);
+        fRunAction->AddDriftSteps(electrons, steps, fixedSteps, stalled);
+      }
+
+      fRunAction->GetDigitiser()->Digitise(evt);
+    }
+
+    UpdateStopCondition(PKE);
+
 }
 
 void EventAction::EDepPrim(const G4double &Ed)
@@ -77,4 +142,54 @@ void EventAction::EDepPrim(const G4double &Ed)
   fEDepPrim+=Ed;
 }
 
+void EventAction::BeginOfRun()
+{
+  // Start the estimators and the wall time again
+  fStats.clear();
+  fRunStart = std::chrono::steady_clock::now();
+}
+
+void EventAction::UpdateStopCondition(G4double PKE)
+{
+  if (!fStopEnabled) return;
+
+  G4RunManager* runManager = G4RunManager::GetRunManager();
+  G4int runID = runManager->GetCurrentRun()->GetRunID();
+
+  fStats["camera"].Add(fCameraYield);
+  fStats["pmt"].Add(fPMTYield);
+  fStats["edep"].Add(fEDepPrim);
+  if (PKE > 0.)
+    fStats["yield"].Add(fCameraYield/(PKE/MeV));
+
+  auto stat = fStats.find(fStopObservable);
+  if (stat == fStats.end() || stat->second.n < fStopMinEvents) return;
+
+  G4double elapsed = std::chrono::duration<G4double>(std::chrono::steady_clock::now() - fRunStart).count();
+  G4double error = std::sqrt(stat->second.Variance()/stat->second.n);
+  G4bool precise = stat->second.mean != 0. && error/std::abs(stat->second.mean) < fStopPrecision;
+  G4bool outOfTime = fStopWallTime > 0. && elapsed > fStopWallTime/s;
+
+  if (precise || outOfTime){
+    G4cout << "EventAction: stopping run " << runID << " after " << stat->second.n << " events and "
+           << elapsed << " s, " << (precise ? "precision reached" : "wall time reached") << G4endl;
+    PrintEstimates();
+    runManager->AbortRun(true); // finish the current event
+  }
+}
+
+void EventAction::PrintEstimates()
+{
+  for (const auto& stat : fStats){
+    G4double sigma = std::sqrt(stat.second.Variance());
+    G4double mean = stat.second.mean;
+    G4double error = sigma/std::sqrt((G4double)stat.second.n);
+    G4cout << "  " << stat.first << ": mean " << mean << " +- " << error;
+    // Relative resolution and its error for a gaussian sample
+    if (mean != 0. && stat.second.n > 1)
+      G4cout << ", resolution " << sigma/mean << " +- " << sigma/mean/std::sqrt(2.*(stat.second.n - 1));
+    G4cout << G4endl;
+  }
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -3,25 +3,66 @@
 
 #include "G4UserEventAction.hh"
 #include "G4ThreeVector.hh"
+#include "G4GenericMessenger.hh"
+#include <chrono>
+#include <map>
 #include <vector>
 
 class G4VPhysicalVolume;
 class SteppingAction;
+class RunAction;
+class OpticalWeightWindow;
+class ReadoutGate;
 class G4Event;
 
 
 class EventAction : public G4UserEventAction {
  public:
-  EventAction();
+  EventAction(RunAction*);
   ~EventAction();
 
  public:
   void BeginOfEventAction(const G4Event *);
   void EndOfEventAction(const G4Event *);
   void EDepPrim(const G4double&);  
+  // Called by the run action, restarts the stop condition
+  void BeginOfRun();
+
+  // Weighted photons detected by the camera and the PMT
+  inline void AddCameraWeight(G4double w) {fCameraYield += w;};
+  inline void AddPMTWeight(G4double w) {fPMTYield += w;};
+  inline void SetWeightWindow(OpticalWeightWindow* ww) {fWeightWindow = ww;};
+  inline void SetReadoutGate(ReadoutGate* rg) {fReadoutGate = rg;};
 
  private:
+  // Running mean and variance of a per-event observable (Welford)
+  struct RunningStat {
+    G4long n = 0;
+    G4double mean = 0.;
+    G4double m2 = 0.;
+    void Add(G4double x) {n++; G4double d = x - mean; mean += d/n; m2 += d*(x - mean);};
+    G4double Variance() const {return n > 1 ? m2/(n - 1) : 0.;};
+  };
+
+  // Stop the run once the observable is known to the requested precision
+  void UpdateStopCondition(G4double PKE);
+  void PrintEstimates();
+
+  G4GenericMessenger* stopMsg_;
+  G4bool fStopEnabled;
+  G4String fStopObservable;  // camera, pmt, edep or yield
+  G4double fStopPrecision;   // relative error of the mean
+  G4int fStopMinEvents;
+  G4double fStopWallTime;    // seconds, 0 for no limit
+  std::chrono::steady_clock::time_point fRunStart;
+  std::map<G4String, RunningStat> fStats;
+
+  RunAction* fRunAction;
+  OpticalWeightWindow* fWeightWindow;
+  ReadoutGate* fReadoutGate;
   G4double fEDepPrim;
+  G4double fCameraYield;
+  G4double fPMTYield;
 
 
 };
@@ -17,14 +17,16 @@ void MyUserActionInitialization::Build() const {
         PrimaryGeneratorAction* primary = new PrimaryGeneratorAction();
 	SetUserAction(primary);
 
-	EventAction* evt = new EventAction();
+	RunAction* runAct = new RunAction();
+	SetUserAction(runAct);
+
+	EventAction* evt = new EventAction(runAct);
 	SetUserAction(evt);
+	runAct->SetEventAction(evt);
 
 	SteppingAction* stepAct = new SteppingAction(evt);
 	SetUserAction(stepAct);
 
-	SetUserAction(new RunAction());
-
 	SetUserAction(new NESTStackingAction()); // comment to launch, e.g., opticalphotons as primaries. EC, 29-July-2022.
 	TrackingAction* trackAct = new TrackingAction();
 	SetUserAction(trackAct);
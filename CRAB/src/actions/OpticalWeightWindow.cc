@@ -0,0 +1,94 @@
+#include "OpticalWeightWindow.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4UIcommand.hh"
+#include "G4Tokenizer.hh"
+#include "G4LogicalBorderSurface.hh"
+#include "G4OpticalSurface.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "Randomize.hh"
+
+OpticalWeightWindow::OpticalWeightWindow() :
+  enabled_(false), nReflections_(0), survival_(1.), nKilled_(0), nSurvived_(0) {
+
+  msg_ = new G4GenericMessenger(this, "/Action/WeightWindow/",
+    "Russian roulette of reflecting optical photons.");
+
+  msg_->DeclareProperty("enable", enabled_, "Roulette optical photons according to the volume rules");
+  msg_->DeclareMethod("addVolume", &OpticalWeightWindow::AddVolume,
+    "Add a rule: <volume|all> <maxReflections> <minSurvival> <survivalProbability>");
+  msg_->DeclareMethod("clear", &OpticalWeightWindow::Clear, "Remove all rules");
+}
+
+OpticalWeightWindow::~OpticalWeightWindow() {
+  delete msg_;
+}
+
+void OpticalWeightWindow::AddVolume(G4String values) {
+  G4Tokenizer next(values);
+  G4String volume = next();
+  Rule rule;
+  rule.maxReflections = G4UIcommand::ConvertToInt(next());
+  rule.minSurvival    = G4UIcommand::ConvertToDouble(next());
+  rule.probability    = G4UIcommand::ConvertToDouble(next());
+
+  if (rule.probability <= 0. || rule.probability > 1.)
+    G4Exception("[OpticalWeightWindow]", "AddVolume()", FatalException,
+                ("Survival probability must be in (0,1]: " + values).c_str());
+
+  rules_[volume] = rule;
+}
+
+void OpticalWeightWindow::Clear() {
+  rules_.clear();
+}
+
+void OpticalWeightWindow::NewTrack() {
+  nReflections_ = 0;
+  survival_ = 1.;
+}
+
+G4bool OpticalWeightWindow::Reflected(const G4Step* step, G4Track* track) {
+  if (!enabled_ || rules_.empty()) return true;
+
+  // The post step point is in the volume the photon reflected off
+  G4VPhysicalVolume* prePV  = step->GetPreStepPoint()->GetPhysicalVolume();
+  G4VPhysicalVolume* postPV = step->GetPostStepPoint()->GetPhysicalVolume();
+  if (!postPV) return true;
+
+  auto rule = rules_.find(postPV->GetLogicalVolume()->GetName());
+  if (rule == rules_.end()) rule = rules_.find("all");
+  if (rule == rules_.end()) return true;
+
+  nReflections_++;
+
+  // Analog survival probability so far, from the reflectivity of the surface
+  if (rule->second.minSurvival > 0.){
+    G4LogicalBorderSurface* border = G4LogicalBorderSurface::GetSurface(prePV, postPV);
+    G4OpticalSurface* surface = border ? dynamic_cast<G4OpticalSurface*>(border->GetSurfaceProperty()) : nullptr;
+    if (surface && surface->GetMaterialPropertiesTable()){
+      G4MaterialPropertyVector* reflectivity = surface->GetMaterialPropertiesTable()->GetProperty("REFLECTIVITY");
+      if (reflectivity)
+        survival_ *= reflectivity->Value(track->GetKineticEnergy());
+    }
+  }
+
+  if (nReflections_ < rule->second.maxReflections && survival_ >= rule->second.minSurvival)
+    return true;
+
+  // Roulette, then start counting again for the survivor
+  nReflections_ = 0;
+  survival_ = 1.;
+
+  if (G4UniformRand() < rule->second.probability){
+    track->SetWeight(track->GetWeight()/rule->second.probability);
+    nSurvived_++;
+    return true;
+  }
+
+  track->SetTrackStatus(fStopAndKill);
+  nKilled_++;
+  return false;
+}
@@ -0,0 +1,60 @@
+#ifndef OpticalWeightWindow_hh
+#define OpticalWeightWindow_hh 1
+
+#include "G4Types.hh"
+#include "G4String.hh"
+#include "G4GenericMessenger.hh"
+
+#include <map>
+
+class G4Step;
+class G4Track;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Russian roulette for optical photons that keep bouncing off reflective
+// surfaces. A rule per volume (or "all") says after how many reflections, or
+// below which analog survival probability, a photon is rouletted and with
+// which probability it survives. Survivors carry weight 1/p so the scorers
+// stay unbiased.
+class OpticalWeightWindow {
+ public:
+  OpticalWeightWindow();
+  ~OpticalWeightWindow();
+
+  // Called by the stepping action after every reflection of an optical photon.
+  // Returns false if the photon was killed.
+  G4bool Reflected(const G4Step*, G4Track*);
+
+  // Called when a new track starts
+  void NewTrack();
+
+  inline G4bool IsEnabled() const {return enabled_;};
+  inline G4int GetKilled() const {return nKilled_;};
+  inline G4int GetSurvived() const {return nSurvived_;};
+  inline void ResetCounters() {nKilled_ = 0; nSurvived_ = 0;};
+
+ private:
+  struct Rule {
+    G4int maxReflections;  // roulette after this many reflections
+    G4double minSurvival;  // or when the analog survival probability drops below this
+    G4double probability; // survival probability of the roulette
+  };
+
+  // "volume maxReflections minSurvival probability"
+  void AddVolume(G4String);
+  void Clear();
+
+  G4GenericMessenger* msg_;
+  G4bool enabled_;
+  std::map<G4String, Rule> rules_;
+
+  G4int nReflections_;
+  G4double survival_;
+  G4int nKilled_;
+  G4int nSurvived_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
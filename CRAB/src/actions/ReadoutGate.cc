@@ -0,0 +1,74 @@
+#include "ReadoutGate.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+
+#include "DetectorConstruction.hh"
+
+ReadoutGate::ReadoutGate() :
+  enabled_(false), cameraWindow_(DBL_MAX), pmtWindow_(DBL_MAX), windowZ_(-1.),
+  nCulled_(0), culledTime_(0.) {
+
+  msg_ = new G4GenericMessenger(this, "/Action/ReadoutWindow/",
+    "Culling of optical photons outside the readout window.");
+
+  msg_->DeclareProperty("enable", enabled_, "Kill photons that cannot arrive inside the readout windows");
+  msg_->DeclarePropertyWithUnit("cameraWindow", "ns", cameraWindow_, "End of the camera readout window");
+  msg_->DeclarePropertyWithUnit("pmtWindow", "ns", pmtWindow_, "End of the PMT readout window");
+  msg_->DeclareMethod("killVolume", &ReadoutGate::AddKillVolume,
+    "Kill photons as soon as they enter this logical volume");
+}
+
+ReadoutGate::~ReadoutGate() {
+  delete msg_;
+}
+
+void ReadoutGate::AddKillVolume(G4String volume) {
+  killVolumes_.insert(volume);
+}
+
+void ReadoutGate::NewTrack() {
+  if (enabled_) trackStart_ = std::chrono::steady_clock::now();
+}
+
+void ReadoutGate::Cull(G4Track* track) {
+  track->SetTrackStatus(fStopAndKill);
+  nCulled_++;
+  culledTime_ += std::chrono::duration<G4double>(std::chrono::steady_clock::now() - trackStart_).count();
+}
+
+G4bool ReadoutGate::Check(const G4Step* step, G4Track* track) {
+  if (!enabled_) return true;
+
+  if (windowZ_ < 0.){
+    auto det = static_cast<const DetectorConstruction*>(G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    windowZ_ = det->GetWindowZ();
+  }
+
+  const G4StepPoint* post = step->GetPostStepPoint();
+
+  G4VPhysicalVolume* postPV = post->GetPhysicalVolume();
+  if (postPV && !killVolumes_.empty() &&
+      killVolumes_.count(postPV->GetLogicalVolume()->GetName())){
+    Cull(track);
+    return false;
+  }
+
+  // Straight line at c to the window plane is a lower bound of the arrival time
+  G4double time = post->GetGlobalTime();
+  G4double z = post->GetPosition().z();
+  G4double tCamera = time + std::max(0., windowZ_ - z)/c_light;
+  G4double tPMT    = time + std::max(0., z + windowZ_)/c_light;
+
+  if (tCamera > cameraWindow_ && tPMT > pmtWindow_){
+    Cull(track);
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,56 @@
+#ifndef ReadoutGate_hh
+#define ReadoutGate_hh 1
+
+#include "G4Types.hh"
+#include "G4String.hh"
+#include "G4GenericMessenger.hh"
+
+#include <chrono>
+#include <set>
+
+class G4Step;
+class G4Track;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Kills optical photons that can no longer give a hit inside the readout
+// window of any sensor: the global time plus the flight time at the speed of
+// light to the closest sensor window is later than the end of the window.
+// Photons entering one of the listed volumes are killed as well.
+class ReadoutGate {
+ public:
+  ReadoutGate();
+  ~ReadoutGate();
+
+  // Returns false if the photon was killed
+  G4bool Check(const G4Step*, G4Track*);
+
+  // Called when a new track starts
+  void NewTrack();
+
+  inline G4bool IsEnabled() const {return enabled_;};
+  inline G4int GetCulled() const {return nCulled_;};
+  inline G4double GetCulledTime() const {return culledTime_;};
+  inline void ResetCounters() {nCulled_ = 0; culledTime_ = 0.;};
+
+ private:
+  void AddKillVolume(G4String);
+  void Cull(G4Track*);
+
+  G4GenericMessenger* msg_;
+  G4bool enabled_;
+  G4double cameraWindow_; // end of the camera readout window (global time)
+  G4double pmtWindow_;    // end of the PMT readout window (global time)
+  std::set<G4String> killVolumes_;
+
+  // z of the lens (+z) and S1 (-z) windows, nearest possible sensor positions
+  G4double windowZ_;
+
+  std::chrono::steady_clock::time_point trackStart_;
+  G4int nCulled_;
+  G4double culledTime_; // CPU seconds spent on culled photons before the cull
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -9,8 +9,20 @@
 #include "GasBoxSD.hh"
 #include "G4SDManager.hh"
 #include "G4RunManager.hh"
-
-RunAction::RunAction(){
+#include "G4RunManagerKernel.hh"
+#include "G4AccumulableManager.hh"
+#include "PhysicsList.hh"
+#include "Digitiser.hh"
+#include "NESTYieldCache.hh"
+
+#include <algorithm>
+#include <cmath>
+
+RunAction::RunAction() : fNtuplesBooked(false),
+  fNEvents(0), fCameraSum(0.), fCameraSum2(0.), fPMTSum(0.), fPMTSum2(0.),
+  fRouletteKilled(0), fRouletteSurvived(0),
+  fCulledPhotons(0), fCulledTime(0.), fCulledElectrons(0),
+  fDriftElectrons(0), fDriftSteps(0.), fDriftStepsFixed(0.), fDriftStalled(0), fDigitiser(new Digitiser()), fEventAction(nullptr) {
   G4cout << "Creating AnalysisManager" << G4endl;
   auto analysisManager = G4AnalysisManager::Instance();
 //  analysisManager->SetNtupleMerging(true,0,0,10000000);
@@ -22,11 +34,28 @@ RunAction::RunAction(){
   
   analysisManager->SetNtupleActivation(true);
 
+  G4AccumulableManager* accumulableManager = G4AccumulableManager::Instance();
+  accumulableManager->RegisterAccumulable(fNEvents);
+  accumulableManager->RegisterAccumulable(fCameraSum);
+  accumulableManager->RegisterAccumulable(fCameraSum2);
+  accumulableManager->RegisterAccumulable(fPMTSum);
+  accumulableManager->RegisterAccumulable(fPMTSum2);
+  accumulableManager->RegisterAccumulable(fRouletteKilled);
+  accumulableManager->RegisterAccumulable(fRouletteSurvived);
+  accumulableManager->RegisterAccumulable(fCulledPhotons);
+  accumulableManager->RegisterAccumulable(fCulledTime);
+  accumulableManager->RegisterAccumulable(fCulledElectrons);
+  accumulableManager->RegisterAccumulable(fDriftElectrons);
+  accumulableManager->RegisterAccumulable(fDriftSteps);
+  accumulableManager->RegisterAccumulable(fDriftStepsFixed);
+  accumulableManager->RegisterAccumulable(fDriftStalled);
+
   G4cout << "Creating RunAction" << G4endl;
 }
 
 RunAction::~RunAction() { 
 	G4cout << "Deleting RunAction" << G4endl;
+	delete fDigitiser;
 	delete G4AnalysisManager::Instance();  
 }
 
@@ -34,6 +63,13 @@ RunAction::~RunAction() {
 void RunAction::BeginOfRunAction(const G4Run* aRun) {
   G4Random::showEngineStatus();
 
+  // Physics tables are built by now, store them for the next start-up
+  if (IsMaster()) {
+    PhysicsList* physicsList = dynamic_cast<PhysicsList*>(G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList());
+    if (physicsList)
+      physicsList->UpdatePhysicsTableCache();
+  }
+
   G4cout << "Starting run " << aRun->GetRunID() << G4endl;
   time_t currentTime;
   tm* ptm;
@@ -41,8 +77,15 @@ void RunAction::BeginOfRunAction(const G4Run* aRun) {
   ptm = localtime(&currentTime);
   G4cout << "Time: " << asctime(ptm) << G4endl;
 
+  G4AccumulableManager::Instance()->Reset();
+  if (fEventAction) fEventAction->BeginOfRun();
+
   auto analysisManager = G4AnalysisManager::Instance();
   analysisManager->OpenFile();
+
+  // Ntuples are booked once per process, later runs (e.g. server jobs) reuse them
+  if (fNtuplesBooked) return;
+  fNtuplesBooked = true;
   
   analysisManager->CreateNtuple("Camera", "Camera Hits"); 
   analysisManager->CreateNtupleDColumn("Event");     //column 0
@@ -54,6 +97,7 @@ void RunAction::BeginOfRunAction(const G4Run* aRun) {
   analysisManager->CreateNtupleIColumn("Reflected"); //column 6
   analysisManager->CreateNtupleSColumn("Boundary");  //column 7
   analysisManager->CreateNtupleIColumn("SID");       //column 8
+  analysisManager->CreateNtupleDColumn("Weight");    //column 9
 
   analysisManager->FinishNtuple();
 
@@ -103,6 +147,24 @@ void RunAction::BeginOfRunAction(const G4Run* aRun) {
   analysisManager->CreateNtupleIColumn("Reflected"); //column 6
   analysisManager->CreateNtupleSColumn("Boundary");  //column 7
   analysisManager->CreateNtupleIColumn("SID");       //column 8
+  analysisManager->CreateNtupleDColumn("Weight");    //column 9
+  analysisManager->FinishNtuple();
+
+  analysisManager->CreateNtuple("Image", "Camera image of the lens model"); 
+  analysisManager->CreateNtupleDColumn("Event");     //column 0
+  analysisManager->CreateNtupleIColumn("IX");        //column 1
+  analysisManager->CreateNtupleIColumn("IY");        //column 2
+  analysisManager->CreateNtupleDColumn("X");         //column 3
+  analysisManager->CreateNtupleDColumn("Y");         //column 4
+  analysisManager->CreateNtupleDColumn("Counts");    //column 5
+  analysisManager->FinishNtuple();
+
+  analysisManager->CreateNtuple("Waveform", "Digitised PMT waveforms"); 
+  analysisManager->CreateNtupleDColumn("Event");          //column 0
+  analysisManager->CreateNtupleIColumn("Sensor");         //column 1
+  analysisManager->CreateNtupleDColumn("StartTime");      //column 2
+  analysisManager->CreateNtupleDColumn("SamplingPeriod"); //column 3
+  analysisManager->CreateNtupleDColumn("Samples", fDigitiser->GetSamples()); //column 4
   analysisManager->FinishNtuple();
 
   analysisManager->SetNtupleActivation(true);
@@ -114,6 +176,36 @@ void RunAction::EndOfRunAction(const G4Run* aRun) {
   analysisManager->Write();
   analysisManager->CloseFile();
 
+  G4AccumulableManager::Instance()->Merge();
+
+  NESTYieldCache::PrintStatistics();
+
+  // Weighted yields per event, compare a run with /Action/WeightWindow/enable
+  // against an analog one to check that the roulette is unbiased
+  if (IsMaster() && fNEvents.GetValue() > 0) {
+    G4double n = fNEvents.GetValue();
+    auto meanAndError = [n](G4double sum, G4double sum2) {
+      G4double mean = sum/n;
+      G4double var  = n > 1 ? (sum2/n - mean*mean)*n/(n-1) : 0.;
+      return std::make_pair(mean, std::sqrt(std::max(var, 0.)/n));
+    };
+    auto camera = meanAndError(fCameraSum.GetValue(), fCameraSum2.GetValue());
+    auto pmt    = meanAndError(fPMTSum.GetValue(), fPMTSum2.GetValue());
+    G4cout << "Weighted photons per event over " << fNEvents.GetValue() << " events:" << G4endl
+           << "  camera " << camera.first << " +- " << camera.second << G4endl
+           << "  PMT    " << pmt.first << " +- " << pmt.second << G4endl
+           << "  roulette killed " << fRouletteKilled.GetValue()
+           << ", survived " << fRouletteSurvived.GetValue() << G4endl
+           << "  readout window culled " << fCulledPhotons.GetValue() << " photons ("
+           << fCulledTime.GetValue() << " s CPU before the cull), "
+           << fCulledElectrons.GetValue() << " electrons not drifted" << G4endl;
+    if (fDriftElectrons.GetValue() > 0)
+      G4cout << "  drift steps per electron " << fDriftSteps.GetValue()/fDriftElectrons.GetValue()
+             << ", with fixed steps about " << fDriftStepsFixed.GetValue()/fDriftElectrons.GetValue()
+             << " (estimated from the path length, " << fDriftElectrons.GetValue() << " electrons, "
+             << fDriftStalled.GetValue() << " stopped at a band edge)" << G4endl;
+  }
+
   G4cout << "End of run OK!" << G4endl;
   time_t currentTime;
   tm* ptm;
@@ -125,3 +217,26 @@ void RunAction::EndOfRunAction(const G4Run* aRun) {
 
 
 }
+
+void RunAction::AddEvent(G4double cameraYield, G4double pmtYield, G4int killed, G4int survived) {
+  fNEvents += 1;
+  fCameraSum  += cameraYield;
+  fCameraSum2 += cameraYield*cameraYield;
+  fPMTSum     += pmtYield;
+  fPMTSum2    += pmtYield*pmtYield;
+  fRouletteKilled   += killed;
+  fRouletteSurvived += survived;
+}
+
+void RunAction::AddCulled(G4int photons, G4double cpuTime, G4int electrons) {
+  fCulledPhotons   += photons;
+  fCulledTime      += cpuTime;
+  fCulledElectrons += electrons;
+}
+
+void RunAction::AddDriftSteps(G4int electrons, G4double steps, G4double fixedSteps, G4int stalled) {
+  fDriftElectrons += electrons;
+  fDriftSteps += steps;
+  fDriftStepsFixed += fixedSteps;
+  fDriftStalled += stalled;
+}
@@ -2,6 +2,7 @@
 #define RunAction_hh 1
 
 #include "G4UserRunAction.hh"
+#include "G4Accumulable.hh"
 
 
 #include "TROOT.h"
@@ -13,6 +14,7 @@
 
 class PhysicsList;
 class EventAction;
+class Digitiser;
 // Run action class, carries out tasks at the begin and end of each run.
 // The concept of a run incorporates a fixed geometry, fixed beam conditions,
 // simulation of number of primaries.
@@ -29,8 +31,39 @@ class RunAction : public G4UserRunAction {
   void BeginOfRunAction(const G4Run *);
   void EndOfRunAction(const G4Run *);
 
+  // Weighted number of photons seen by the camera and PMT in one event and
+  // roulette decisions of the weight window, summed over the run
+  void AddEvent(G4double cameraYield, G4double pmtYield, G4int killed, G4int survived);
+
+  // Tracks killed by the readout window (with the CPU time they had used) and
+  // electrons not drifted because they cannot reach the EL region
+  void AddCulled(G4int photons, G4double cpuTime, G4int electrons);
+  void AddDriftSteps(G4int electrons, G4double steps, G4double fixedSteps, G4int stalled);
+
+  inline Digitiser* GetDigitiser() {return fDigitiser;};
+  // Event action of this thread, told when a run starts
+  inline void SetEventAction(EventAction* ea) {fEventAction = ea;};
+
 
  private:
+  G4bool fNtuplesBooked;
+
+  G4Accumulable<G4int> fNEvents;
+  G4Accumulable<G4double> fCameraSum;
+  G4Accumulable<G4double> fCameraSum2;
+  G4Accumulable<G4double> fPMTSum;
+  G4Accumulable<G4double> fPMTSum2;
+  G4Accumulable<G4int> fRouletteKilled;
+  G4Accumulable<G4int> fRouletteSurvived;
+  G4Accumulable<G4int> fCulledPhotons;
+  G4Accumulable<G4double> fCulledTime;
+  G4Accumulable<G4int> fCulledElectrons;
+  G4Accumulable<G4int> fDriftElectrons;
+  G4Accumulable<G4double> fDriftSteps;
+  G4Accumulable<G4double> fDriftStepsFixed;
+  G4Accumulable<G4int> fDriftStalled;
 
+  Digitiser* fDigitiser;
+  EventAction* fEventAction;
 };
 #endif
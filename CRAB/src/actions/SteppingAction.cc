@@ -19,6 +19,12 @@ SteppingAction::SteppingAction(EventAction *eva) : fEventAction(eva),  ev_shift(
     "Control commands of the stepping action.");
 
   msg_->DeclareProperty("event_shift", ev_shift, "Set the event ID Shift number");
+
+  fWeightWindow = new OpticalWeightWindow();
+  fEventAction->SetWeightWindow(fWeightWindow);
+
+  fReadoutGate = new ReadoutGate();
+  fEventAction->SetReadoutGate(fReadoutGate);
   
 }
 
@@ -52,12 +58,20 @@ void SteppingAction::UserSteppingAction(const G4Step *aStep)
   if (trackID != track->GetTrackID()){
     trackID =  track->GetTrackID();
     reflected = false;
+    fWeightWindow->NewTrack();
+    fReadoutGate->NewTrack();
   }
 
   const G4ParticleDefinition* particle = track->GetParticleDefinition();
   G4int pID       = particle->GetPDGEncoding();
   G4double time   = aStep->GetPreStepPoint()->GetGlobalTime();
 
+  // Photons that can no longer arrive inside the readout window
+  if (fReadoutGate->IsEnabled() &&
+      (particle == S2Photon::OpticalPhoton() || particle == G4OpticalPhoton::OpticalPhoton())){
+    if (!fReadoutGate->Check(aStep, track)) return;
+  }
+
   G4OpBoundaryProcess* boundary = 0;
   // if (!boundary &&  particle->GetParticleName() == "S2Photon") {
   if (!boundary){
@@ -90,6 +104,14 @@ void SteppingAction::UserSteppingAction(const G4Step *aStep)
                 Material_Store = aStep->GetPreStepPoint()->GetTouchableHandle()->GetVolume()->GetLogicalVolume()->GetName();
               }
 
+              // Roulette photons that have been reflected too often
+              G4OpBoundaryProcessStatus status = boundary->GetStatus();
+              if (fWeightWindow->IsEnabled() && aStep->GetPostStepPoint()->GetStepStatus() == fGeomBoundary &&
+                  (status == SpikeReflection || status == LobeReflection || status == BackScattering ||
+                   status == LambertianReflection || status == FresnelReflection || status == TotalInternalReflection)){
+                if (!fWeightWindow->Reflected(aStep, track)) return;
+              }
+
               break;
           }
       }
@@ -154,8 +176,10 @@ void SteppingAction::UserSteppingAction(const G4Step *aStep)
       }
 
       analysisManager->FillNtupleIColumn(id,8, PhotonType);
+      analysisManager->FillNtupleDColumn(id,9, track->GetWeight());
     
       analysisManager->AddNtupleRow(id);
+      fEventAction->AddCameraWeight(track->GetWeight());
 
       // if (reflected) std::cout << "Parent ID from reflected photon Detected: " << track->GetTrackID() << "  Material:  " << Material_Store << std::endl;
       // else  std::cout << "Photon arrived but was not reflected: " << track->GetTrackID() << std::endl;
@@ -198,8 +222,10 @@ void SteppingAction::UserSteppingAction(const G4Step *aStep)
       }
 
       analysisManager->FillNtupleIColumn(id,8, PhotonType);
+      analysisManager->FillNtupleDColumn(id,9, track->GetWeight());
 
       analysisManager->AddNtupleRow(id);
+      fEventAction->AddPMTWeight(track->GetWeight());
     
     }
 
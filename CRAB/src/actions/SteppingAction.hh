@@ -8,6 +8,8 @@
 #include "EventAction.hh"
 #include "Analysis.hh"
 #include "G4GenericMessenger.hh"
+#include "OpticalWeightWindow.hh"
+#include "ReadoutGate.hh"
 
 #include <vector>
 
@@ -17,7 +19,7 @@
 class SteppingAction : public G4UserSteppingAction {
  public:
   SteppingAction(EventAction *eva);
-  ~SteppingAction(){};
+  ~SteppingAction(){delete fWeightWindow; delete fReadoutGate;};
 
   void UserSteppingAction(const G4Step *);
  
@@ -25,6 +27,8 @@ class SteppingAction : public G4UserSteppingAction {
   EventAction* fEventAction;
 
   G4GenericMessenger* msg_;
+  OpticalWeightWindow* fWeightWindow;
+  ReadoutGate* fReadoutGate;
 
   G4int ev_shift;
 
@@ -0,0 +1,162 @@
+#include "EventLibrary.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cstring>
+
+EventLibrary* EventLibrary::GetInstance(){
+  static EventLibrary instance;
+  return &instance;
+}
+
+EventLibrary::EventLibrary() :
+  file_(""), skip_(0), runID_(-1), capacity_(1000),
+  nextToRead_(0), wanted_(-1), eof_(true), truncated_(false), stop_(false) {
+}
+
+EventLibrary::~EventLibrary(){
+  Close();
+}
+
+void EventLibrary::SetCapacity(G4int capacity){
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity > 0 ? capacity : 1;
+  }
+  consumed_.notify_all();
+}
+
+void EventLibrary::Open(const G4String& file, G4int skip){
+  in_.open(file, std::ios::binary);
+  if (!in_.is_open())
+    G4Exception("[EventLibrary]", "Open()", FatalException,
+                ("Could not open event library " + file).c_str());
+
+  char magic[8];
+  in_.read(magic, 8);
+  if (!in_ || std::strncmp(magic, "CRABLIB1", 8) != 0)
+    G4Exception("[EventLibrary]", "Open()", FatalException,
+                (file + " is not an event library, convert it with convertEventLibrary.py").c_str());
+
+  size_t capacity;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity = capacity_;
+    file_ = file;
+    skip_ = skip;
+    buffer_.clear();
+    nextToRead_ = 0;
+    wanted_ = -1;
+    eof_ = false;
+    truncated_ = false;
+    stop_ = false;
+  }
+
+  thread_ = std::thread(&EventLibrary::Prefetch, this);
+  G4cout << "EventLibrary: reading " << file << " from event " << skip
+         << " with " << capacity << " events ahead" << G4endl;
+}
+
+void EventLibrary::Close(){
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  consumed_.notify_all();
+  if (thread_.joinable()) thread_.join();
+  if (in_.is_open()) in_.close();
+}
+
+G4bool EventLibrary::ReadEvent(Event& event, G4bool keep){
+  int32_t n = 0;
+  in_.read(reinterpret_cast<char*>(&n), sizeof(n));
+  if (!in_) return false;
+
+  if (!keep){
+    in_.seekg(n*kRecordSize, std::ios::cur);
+    return (bool)in_;
+  }
+
+  std::vector<char> block(n*kRecordSize);
+  in_.read(block.data(), block.size());
+  if (!in_) return false;
+
+  event.resize(n);
+  for (int32_t i = 0; i < n; i++){
+    const char* record = block.data() + i*kRecordSize;
+    int32_t pdg;
+    float v[8];
+    std::memcpy(&pdg, record, 4);
+    std::memcpy(v, record + 4, sizeof(v));
+
+    Primary& p = event[i];
+    p.pdg = pdg;
+    p.energy = v[0]*keV;
+    p.direction = G4ThreeVector(v[1], v[2], v[3]);
+    p.position = G4ThreeVector(v[4], v[5], v[6])*mm;
+    p.time = v[7]*ns;
+  }
+  return true;
+}
+
+void EventLibrary::Prefetch(){
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_ && !eof_){
+    // Read ahead up to the capacity, or further if a worker needs a later event
+    consumed_.wait(lock, [this]{
+      return stop_ || buffer_.size() < capacity_ || wanted_ >= nextToRead_;
+    });
+    if (stop_) break;
+
+    G4int index = nextToRead_;
+    G4bool keep = index >= skip_;
+    lock.unlock();
+
+    Event event;
+    G4bool ok = ReadEvent(event, keep);
+
+    lock.lock();
+    if (ok){
+      if (keep) buffer_[index] = std::move(event);
+      nextToRead_++;
+    }
+    else {
+      eof_ = true;
+      truncated_ = !in_.eof() || in_.gcount() != 0;
+    }
+    produced_.notify_all();
+  }
+}
+
+G4bool EventLibrary::GetEvent(const G4String& file, G4int skip, G4int runID, G4int eventID, Event& event){
+  {
+    std::lock_guard<std::mutex> open(openMutex_);
+    if (file != file_ || skip != skip_ || runID != runID_){
+      Close();
+      Open(file, skip);
+      runID_ = runID;
+    }
+  }
+
+  G4int index = skip + eventID;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  wanted_ = std::max(wanted_, index);
+  consumed_.notify_all();
+  produced_.wait(lock, [&]{ return index < nextToRead_ || eof_; });
+
+  auto it = buffer_.find(index);
+  if (it == buffer_.end()){
+    if (truncated_)
+      G4Exception("[EventLibrary]", "GetEvent()", JustWarning,
+                  (file_ + " is truncated").c_str());
+    return false;
+  }
+
+  event = std::move(it->second);
+  buffer_.erase(it);
+  lock.unlock();
+  consumed_.notify_all();
+  return true;
+}
@@ -0,0 +1,82 @@
+//
+// Event library read by the primary generator (Mode Library). External
+// generator outputs (Pb-210 chains, Rn progeny, cosmogenics) are converted once
+// to a compact binary file with convertEventLibrary.py. A background thread
+// reads it ahead into a bounded buffer and the worker threads take the event
+// with their event ID from there, so start-up does not parse the whole file and
+// memory does not grow with its size.
+//
+// File layout (native little endian):
+//   "CRABLIB1"
+//   per event: int32 nPrimaries, then per primary
+//     int32 PDG code, float32 kinetic energy [keV], direction dx dy dz,
+//     vertex x y z [mm], time [ns]
+//
+
+#ifndef EventLibrary_hh
+#define EventLibrary_hh 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class EventLibrary {
+  public:
+    struct Primary {
+      G4int pdg;
+      G4double energy;
+      G4ThreeVector direction;
+      G4ThreeVector position;
+      G4double time;
+    };
+    typedef std::vector<Primary> Event;
+
+    // One library is shared by all the worker threads
+    static EventLibrary* GetInstance();
+
+    // Primaries of library event eventID + skip. The library is (re)started
+    // from the top of the file whenever the file, skip or run changes.
+    // Returns false when the file has no such event.
+    G4bool GetEvent(const G4String& file, G4int skip, G4int runID, G4int eventID, Event&);
+
+    // Maximum number of events read ahead, may change while the reader runs
+    void SetCapacity(G4int capacity);
+
+  private:
+    EventLibrary();
+    ~EventLibrary();
+
+    void Open(const G4String& file, G4int skip);
+    void Close();
+    void Prefetch();
+    G4bool ReadEvent(Event&, G4bool keep);
+
+    static constexpr size_t kRecordSize = 4 + 8*4; // pdg + 8 floats
+
+    std::mutex openMutex_;           // held while checking or restarting the reader
+    std::mutex mutex_;               // protects the buffer and the reader state
+    std::condition_variable produced_;
+    std::condition_variable consumed_;
+
+    std::thread thread_;
+    std::ifstream in_;
+    G4String file_;
+    G4int skip_;
+    G4int runID_;
+    size_t capacity_;
+
+    std::map<G4int, Event> buffer_; // read ahead, keyed by library event index
+    G4int nextToRead_;
+    G4int wanted_;                  // highest index a worker is waiting for
+    G4bool eof_;
+    G4bool truncated_;
+    G4bool stop_;
+};
+
+#endif
@@ -44,12 +44,20 @@
 #include "G4ProcessTable.hh"
 #include "G4RadioactiveDecay.hh"
 #include "Randomize.hh"
+#include "G4RandomDirection.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "DetectorConstruction.hh"
+#include "EventLibrary.hh"
 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 PrimaryGenerator::PrimaryGenerator()
-  : G4VPrimaryGenerator(), momentum_(1,1,1),energy_(0),ParticleType_("opticalphoton"),Position_(0),Iso_(true),useNeedle(true)
+  : G4VPrimaryGenerator(), momentum_(1,1,1),energy_(0),ParticleType_("opticalphoton"),Position_(0),Iso_(true),useNeedle(true),
+    ClusterSource_("point"),ClusterElectrons_(1000),ClusterPos_(0),ClusterSize_(0),ClusterTime_(0),ClusterEnergy_(0.1*eV),
+    WValue_(21.9*eV),FanoFactor_(0.15),ClusterFile_(""),
+    LibraryFile_(""),LibrarySkip_(0),LibraryPrefetch_(1000)
 {
 
   msg_ = new G4GenericMessenger(this, "/Generator/SingleParticle/",
@@ -63,6 +71,26 @@ PrimaryGenerator::PrimaryGenerator()
   msg_->DeclareProperty("useNeedle",  useNeedle, "Isotropic Distribution");
   msg_->DeclareProperty("Mode",  GeneratorMode_, "The mode of the generator to run");
 
+  clusterMsg_ = new G4GenericMessenger(this, "/Generator/Cluster/",
+    "Ionisation clusters injected as thermal electrons (Mode Cluster).");
+
+  clusterMsg_->DeclareProperty("source", ClusterSource_, "point, uniform (in the field cage), kr83m or file");
+  clusterMsg_->DeclareProperty("nElectrons", ClusterElectrons_, "Electrons per cluster for point and uniform");
+  clusterMsg_->DeclarePropertyWithUnit("pos", "cm", ClusterPos_, "Position of the point source");
+  clusterMsg_->DeclarePropertyWithUnit("size", "mm", ClusterSize_, "Gaussian sigma of the cluster, 0 for point-like");
+  clusterMsg_->DeclarePropertyWithUnit("time", "ns", ClusterTime_, "Time of the cluster");
+  clusterMsg_->DeclarePropertyWithUnit("energy", "eV", ClusterEnergy_, "Electron kinetic energy, must be below the thermal energy cut");
+  clusterMsg_->DeclarePropertyWithUnit("WValue", "eV", WValue_, "Energy per electron for the kr83m source");
+  clusterMsg_->DeclareProperty("Fano", FanoFactor_, "Fano factor for the kr83m source");
+  clusterMsg_->DeclareProperty("file", ClusterFile_, "CSV of clusters: event,x,y,z [cm],electrons, relative to $CRABPATH/data/");
+
+  libraryMsg_ = new G4GenericMessenger(this, "/Generator/Library/",
+    "Primaries read from a binary event library (Mode Library).");
+
+  libraryMsg_->DeclareProperty("file", LibraryFile_, "Event library, absolute or relative to $CRABPATH/data/");
+  libraryMsg_->DeclareProperty("skip", LibrarySkip_, "Library events to skip before the first event of a run");
+  libraryMsg_->DeclareProperty("prefetch", LibraryPrefetch_, "Events read ahead by the background thread");
+
     //msg_->DeclareProperty("pos", "cm",  Position_, "Set Position x,y,z");
   //  --- Get Xenon file --- 
 	char* nexus_path = std::getenv("CRABPATH");
@@ -93,6 +121,13 @@ void PrimaryGenerator::Generate(G4Event* event, std::vector<double> &xyz){
     std::cout <<"Generating with Single Particle Mode for event: " << event->GetEventID() << std::endl;
     GenerateSingleParticle(event);
   }
+  else if (GeneratorMode_ == "Cluster"){
+    std::cout <<"Generating with Cluster Mode for event: " << event->GetEventID() << std::endl;
+    GenerateCluster(event);
+  }
+  else if (GeneratorMode_ == "Library"){
+    GenerateLibrary(event);
+  }
   else {
     std::cout <<"Generating with Ion Mode for event: " << event->GetEventID() << std::endl;
     GeneratePrimaryVertexIon(event, xyz);
@@ -246,6 +281,128 @@ void PrimaryGenerator::GenerateSingleParticle(G4Event * event) {
     vertexA->Print();
 }
 
-//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PrimaryGenerator::GenerateCluster(G4Event* event) {
+
+    G4ParticleDefinition* electron = G4ParticleTable::GetParticleTable()->FindParticle("thermalelectron");
+    if (!electron)
+        G4Exception("[PrimaryGenerator]", "GenerateCluster()", FatalException,
+                    "thermalelectron is not defined, is NEST in the physics list?");
+
+    auto det = static_cast<const DetectorConstruction*>(G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+
+    // Cluster centres and numbers of electrons
+    G4ThreeVector centre = ClusterPos_;
+    G4int nElectrons = ClusterElectrons_;
+    std::vector<std::pair<G4ThreeVector, G4int>> clusters;
+    G4double energy = 0.;
+
+    if (ClusterSource_ == "uniform" || ClusterSource_ == "kr83m"){
+        // Inside the radius the Garfield model lets into the EL, along the field cage
+        G4double rMax = det->GetActiveR()/2.0*cm;
+        G4double halfL = det->GetActiveL()/2.0*cm;
+        G4double r = rMax*std::sqrt(G4UniformRand());
+        G4double phi = twopi*G4UniformRand();
+        centre = G4ThreeVector(r*std::cos(phi), r*std::sin(phi), (2.*G4UniformRand() - 1.)*halfL);
+
+        // 41.5 keV deposit with Fano fluctuations
+        if (ClusterSource_ == "kr83m"){
+            G4double mean = 41.5*keV/WValue_;
+            nElectrons = std::max(0, (G4int)std::round(G4RandGauss::shoot(mean, std::sqrt(FanoFactor_*mean))));
+            energy = 41.5*keV;
+        }
+        clusters.emplace_back(centre, nElectrons);
+    }
+    else if (ClusterSource_ == "file"){
+        if (cluster_events.empty()){
+            char* crab_path = std::getenv("CRABPATH");
+            FileHandler.GetEventGroups(std::string(crab_path) + "/data/" + ClusterFile_, cluster_events);
+            if (cluster_events.empty())
+                G4Exception("[PrimaryGenerator]", "GenerateCluster()", FatalException,
+                            ("No clusters in " + ClusterFile_).c_str());
+        }
+        // Every cluster of one file event, the file is replayed if the run is longer
+        for (const std::vector<G4double>& row : cluster_events[event->GetEventID() % cluster_events.size()])
+            clusters.emplace_back(G4ThreeVector(row[0], row[1], row[2])*cm, (G4int)row[3]);
+    }
+    else if (ClusterSource_ == "point"){
+        clusters.emplace_back(centre, nElectrons);
+    }
+    else {
+        G4Exception("[PrimaryGenerator]", "GenerateCluster()", FatalException,
+                    ("Unknown cluster source " + ClusterSource_).c_str());
+    }
 
+    G4int total = 0;
+    for (const auto& cluster : clusters){
+        for (G4int i = 0; i < cluster.second; i++){
+            G4ThreeVector pos = cluster.first;
+            if (ClusterSize_ > 0.)
+                pos += G4ThreeVector(G4RandGauss::shoot(0., ClusterSize_), G4RandGauss::shoot(0., ClusterSize_), G4RandGauss::shoot(0., ClusterSize_));
+
+            G4PrimaryParticle* particle = new G4PrimaryParticle(electron);
+            particle->SetKineticEnergy(ClusterEnergy_);
+            particle->SetMomentumDirection(G4RandomDirection());
+
+            G4PrimaryVertex* vertex = new G4PrimaryVertex(pos, ClusterTime_);
+            vertex->SetPrimary(particle);
+            event->AddPrimaryVertex(vertex);
+        }
+        total += cluster.second;
+    }
+
+    // The Event ntuple takes this as the primary energy
+    if (energy == 0.) energy = total*WValue_;
+    event->SetUserInformation(new ClusterInformation(energy));
+
+    std::cout << "PrimaryGenerator: " << ClusterSource_ << " event of " << clusters.size() << " clusters, "
+              << total << " electrons, " << energy/keV << " keV" << std::endl;
+}
 
+void PrimaryGenerator::GenerateLibrary(G4Event* event) {
+
+    if (LibraryFile_ == "")
+        G4Exception("[PrimaryGenerator]", "GenerateLibrary()", FatalException,
+                    "No event library given, use /Generator/Library/file");
+
+    G4String file = LibraryFile_;
+    if (file[0] != '/')
+        file = G4String(std::getenv("CRABPATH")) + "/data/" + file;
+
+    EventLibrary* library = EventLibrary::GetInstance();
+    library->SetCapacity(LibraryPrefetch_);
+
+    G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+    EventLibrary::Event primaries;
+    if (!library->GetEvent(file, LibrarySkip_, runID, event->GetEventID(), primaries)){
+        G4Exception("[PrimaryGenerator]", "GenerateLibrary()", JustWarning,
+                    ("Event library " + LibraryFile_ + " has no more events, stopping the run").c_str());
+        event->SetEventAborted();
+        G4RunManager::GetRunManager()->AbortRun(true);
+        return;
+    }
+
+    G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
+
+    for (const auto& p : primaries){
+        G4ParticleDefinition* definition = particleTable->FindParticle(p.pdg);
+        if (!definition) definition = G4IonTable::GetIonTable()->GetIon(p.pdg);
+        if (!definition){
+            G4Exception("[PrimaryGenerator]", "GenerateLibrary()", JustWarning,
+                        ("Unknown PDG code " + std::to_string(p.pdg) + ", primary skipped").c_str());
+            continue;
+        }
+
+        G4PrimaryParticle* particle = new G4PrimaryParticle(definition);
+        particle->SetKineticEnergy(p.energy);
+        particle->SetMomentumDirection(p.direction.mag2() > 0. ? p.direction.unit() : G4RandomDirection());
+
+        G4PrimaryVertex* vertex = new G4PrimaryVertex(p.position, p.time);
+        vertex->SetPrimary(particle);
+        event->AddPrimaryVertex(vertex);
+    }
+
+    std::cout << "PrimaryGenerator: " << primaries.size() << " primaries from the event library for event "
+              << event->GetEventID() << std::endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
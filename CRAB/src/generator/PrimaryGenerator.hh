@@ -41,9 +41,23 @@
 #include "G4BetaMinusDecay.hh"
 
 #include "FileHandling.hh"
+#include "G4VUserEventInformation.hh"
 
 
 class G4Event;
+
+// Energy of the ionisation injected in Cluster mode, stored with the event
+// because the thermal electrons carry almost none of it
+class ClusterInformation : public G4VUserEventInformation
+{
+  public:
+    explicit ClusterInformation(G4double energy) : energy_(energy) {};
+    inline G4double GetEnergy() const {return energy_;};
+    void Print() const {G4cout << "Cluster energy " << energy_/CLHEP::keV << " keV" << G4endl;};
+
+  private:
+    G4double energy_;
+};
 //class G4DecayProducts;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -58,6 +72,10 @@ class PrimaryGenerator : public G4VPrimaryGenerator
   virtual void GeneratePrimaryVertex(G4Event*) {};
   virtual void GeneratePrimaryVertexIon(G4Event*,std::vector<double> &);
   virtual void GenerateSingleParticle(G4Event*);
+  // Ionisation clusters as thermal electrons, straight into the drift and EL
+  virtual void GenerateCluster(G4Event*);
+  // Primaries read from a binary event library
+  virtual void GenerateLibrary(G4Event*);
   virtual void Generate(G4Event* event, std::vector<double> &xyz); // Choose which generator to launch
 
 
@@ -84,6 +102,24 @@ private:
     G4bool useNeedle;
     G4String GeneratorMode_;
 
+    // Cluster mode
+    G4GenericMessenger* clusterMsg_;
+    G4String ClusterSource_;   // point, uniform, kr83m or file
+    G4int ClusterElectrons_;   // electrons per cluster for point and uniform
+    G4ThreeVector ClusterPos_; // point source position
+    G4double ClusterSize_;     // gaussian sigma of the cluster
+    G4double ClusterTime_;
+    G4double ClusterEnergy_;   // kinetic energy of the electrons, below the thermal energy cut
+    G4double WValue_;
+    G4double FanoFactor_;
+    G4String ClusterFile_;
+    std::vector<std::vector<std::vector<G4double>>> cluster_events; // clusters of each file event
+
+    // Library mode
+    G4GenericMessenger* libraryMsg_;
+    G4String LibraryFile_;
+    G4int LibrarySkip_;        // library events skipped, e.g. per job of an array
+    G4int LibraryPrefetch_;    // events read ahead by the background thread
 
 
 };
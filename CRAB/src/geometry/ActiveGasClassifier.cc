@@ -0,0 +1,144 @@
+#include "ActiveGasClassifier.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4GeometryTolerance.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Navigator.hh"
+#include "G4Tubs.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+ActiveGasClassifier::ActiveGasClassifier(std::vector<std::string> keep)
+    : fKeep(fastsimtrigger::VolumeNameFragments{keep}), fGasPhys(nullptr), fAnalytic(false),
+      fSliceZ0(0.), fSliceWidth(1.), fPoints(0), fLocated(0) {}
+
+ActiveGasClassifier::~ActiveGasClassifier() {}
+
+ActiveGasClassifier::Volume ActiveGasClassifier::Describe(G4VPhysicalVolume* pv, const G4AffineTransform& toLocal) {
+    Volume v;
+    v.pv = pv;
+    v.solid = pv->GetLogicalVolume()->GetSolid();
+    v.toLocal = toLocal;
+    v.keep = fKeep(pv);
+    v.nested = v.keep && pv->GetLogicalVolume()->GetNoDaughters() > 0;
+
+    // Tubes whose axis stays along z are tested by hand
+    G4Tubs* tubs = dynamic_cast<G4Tubs*>(v.solid);
+    G4ThreeVector axis = toLocal.InverseTransformAxis(G4ThreeVector(0., 0., 1.));
+    v.isTube = tubs && tubs->GetDeltaPhiAngle() >= twopi && std::abs(axis.z()) > 1. - 1.e-9;
+    v.rmin = v.isTube ? tubs->GetInnerRadius() : 0.;
+    v.rmax = v.isTube ? tubs->GetOuterRadius() : 0.;
+    v.halfz = v.isTube ? tubs->GetZHalfLength() : 0.;
+    return v;
+}
+
+void ActiveGasClassifier::Build(G4VPhysicalVolume* gasPhys, G4VPhysicalVolume* world) {
+    fGasPhys = gasPhys;
+    fDaughters.clear();
+    fSlices.clear();
+
+    fNavigator.reset(new G4Navigator());
+    fNavigator->SetWorldVolume(world);
+
+    // Without the gas directly in the world every point goes to the navigator
+    fAnalytic = gasPhys->GetMotherLogical() == world->GetLogicalVolume();
+    if (!fAnalytic){
+        G4Exception("[ActiveGasClassifier]", "Build()", JustWarning,
+                    "The gas volume is not placed in the world, points are located with the navigator");
+        return;
+    }
+
+    G4AffineTransform gasToWorld(gasPhys->GetRotation(), gasPhys->GetTranslation());
+    fGas = Describe(gasPhys, gasToWorld.Inverse());
+
+    G4LogicalVolume* gasLogic = gasPhys->GetLogicalVolume();
+    G4ThreeVector gmin, gmax;
+    gasLogic->GetSolid()->BoundingLimits(gmin, gmax);
+
+    // z extent of every daughter in the gas frame, from its bounding box
+    std::vector<std::pair<G4double, G4double>> extent;
+    for (std::size_t i = 0; i < gasLogic->GetNoDaughters(); i++){
+        G4VPhysicalVolume* daughter = gasLogic->GetDaughter(i);
+        G4AffineTransform toGas(daughter->GetRotation(), daughter->GetTranslation());
+        fDaughters.push_back(Describe(daughter, toGas.Inverse()));
+
+        G4ThreeVector bmin, bmax;
+        daughter->GetLogicalVolume()->GetSolid()->BoundingLimits(bmin, bmax);
+        G4double zlo = DBL_MAX, zhi = -DBL_MAX;
+        for (G4int c = 0; c < 8; c++){
+            G4ThreeVector corner((c & 1) ? bmax.x() : bmin.x(), (c & 2) ? bmax.y() : bmin.y(), (c & 4) ? bmax.z() : bmin.z());
+            G4double z = toGas.TransformPoint(corner).z();
+            zlo = std::min(zlo, z);
+            zhi = std::max(zhi, z);
+        }
+        extent.emplace_back(zlo, zhi);
+    }
+
+    // Slices of about a millimetre, at most a few thousand
+    const G4int nSlices = std::max(1, std::min(4096, G4int((gmax.z() - gmin.z())/mm)));
+    fSliceZ0 = gmin.z();
+    fSliceWidth = (gmax.z() - gmin.z())/nSlices;
+    fSlices.resize(nSlices);
+    for (std::size_t i = 0; i < extent.size(); i++){
+        G4int first = std::max(0, G4int(std::floor((extent[i].first - fSliceZ0)/fSliceWidth)));
+        G4int last  = std::min(nSlices - 1, G4int(std::floor((extent[i].second - fSliceZ0)/fSliceWidth)));
+        for (G4int s = first; s <= last; s++)
+            fSlices[s].push_back(i);
+    }
+
+    G4int tubes = std::count_if(fDaughters.begin(), fDaughters.end(), [](const Volume& v){ return v.isTube; });
+    G4cout << "ActiveGasClassifier: " << gasPhys->GetName() << " with " << fDaughters.size()
+           << " daughters, " << tubes << " tested as tubes, " << nSlices << " z slices" << G4endl;
+}
+
+G4int ActiveGasClassifier::Inside(const Volume& v, const G4ThreeVector& point) const {
+    G4ThreeVector local = v.toLocal.TransformPoint(point);
+
+    if (v.isTube){
+        const G4double tol = 0.5*G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+        G4double r = std::sqrt(local.x()*local.x() + local.y()*local.y());
+        G4double z = std::abs(local.z());
+        if (r > v.rmax + tol || r < v.rmin - tol || z > v.halfz + tol) return 0;
+        if (r > v.rmax - tol || (v.rmin > 0. && r < v.rmin + tol) || z > v.halfz - tol) return -1;
+        return 1;
+    }
+
+    EInside in = v.solid->Inside(local);
+    return in == kInside ? 1 : (in == kSurface ? -1 : 0);
+}
+
+G4bool ActiveGasClassifier::Locate(const G4ThreeVector& point) {
+    fLocated++;
+    G4VPhysicalVolume* pv = fNavigator->LocateGlobalPointAndSetup(point, nullptr, false, true);
+    return fKeep(pv);
+}
+
+G4bool ActiveGasClassifier::Contains(const G4ThreeVector& point) {
+    fPoints++;
+    if (!fAnalytic) return Locate(point);
+
+    if (Inside(fGas, point) != 1) return Locate(point);
+
+    G4ThreeVector local = fGas.toLocal.TransformPoint(point);
+    G4int slice = G4int(std::floor((local.z() - fSliceZ0)/fSliceWidth));
+    slice = std::max(0, std::min(G4int(fSlices.size()) - 1, slice));
+
+    for (std::size_t i : fSlices[slice]){
+        const Volume& d = fDaughters[i];
+        G4int in = Inside(d, local);
+        if (in == 0) continue;
+        if (in < 0 || d.nested) return Locate(point);
+        return d.keep;
+    }
+    return fGas.keep;
+}
+
+void ActiveGasClassifier::Classify(const std::vector<G4ThreeVector>& points, std::vector<G4bool>& inside) {
+    inside.resize(points.size());
+    for (std::size_t i = 0; i < points.size(); i++)
+        inside[i] = Contains(points[i]);
+}
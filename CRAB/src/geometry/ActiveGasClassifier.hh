@@ -0,0 +1,81 @@
+/*
+ * ActiveGasClassifier.hh
+ *
+ * Tells whether points lie in the active gas without moving the tracking
+ * navigator. The deepest volume containing a point is kept when its name
+ * contains one of the given fragments, as with a navigator lookup. The gas
+ * volume and its daughters are described once: tubes along z are tested
+ * analytically, other solids with G4VSolid::Inside, and the daughters are
+ * binned in z so that a point is only tested against the few near it.
+ * Points on a surface, outside the gas or inside a kept daughter with
+ * daughters of its own are located with a private navigator.
+ */
+
+#ifndef ActiveGasClassifier_h
+#define ActiveGasClassifier_h 1
+
+#include "G4AffineTransform.hh"
+#include "G4ThreeVector.hh"
+#include "FastSimTrigger.hh"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class G4Navigator;
+class G4VPhysicalVolume;
+class G4VSolid;
+
+class ActiveGasClassifier
+{
+public:
+    explicit ActiveGasClassifier(std::vector<std::string> keep);
+    ~ActiveGasClassifier();
+
+    // Describe the gas volume and its daughters, world is used by the navigator
+    void Build(G4VPhysicalVolume* gasPhys, G4VPhysicalVolume* world);
+    inline G4VPhysicalVolume* GetGasVolume() const {return fGasPhys;};
+
+    G4bool Contains(const G4ThreeVector& point);
+    // inside[i] for points[i]
+    void Classify(const std::vector<G4ThreeVector>& points, std::vector<G4bool>& inside);
+
+    // Points classified since the last call, and how many of them needed the navigator
+    inline void TakeCounts(G4long& points, G4long& located){
+        points = fPoints; located = fLocated; fPoints = 0; fLocated = 0;
+    };
+
+private:
+    // Volume seen through its own frame: a full tube along z or any solid
+    struct Volume {
+        G4VPhysicalVolume* pv;
+        G4VSolid* solid;
+        G4AffineTransform toLocal;
+        G4bool isTube;
+        G4double rmin, rmax, halfz;
+        G4bool keep;
+        G4bool nested;      // kept, with daughters: left to the navigator
+    };
+
+    Volume Describe(G4VPhysicalVolume* pv, const G4AffineTransform& toLocal);
+    // 1 inside, 0 outside, -1 on the surface
+    G4int Inside(const Volume& v, const G4ThreeVector& point) const;
+    G4bool Locate(const G4ThreeVector& point);
+
+    fastsimtrigger::VolumeTrigger fKeep;
+    G4VPhysicalVolume* fGasPhys;
+    G4bool fAnalytic;
+    Volume fGas;
+    std::vector<Volume> fDaughters;
+
+    // Daughters overlapping each z slice of the gas, in its frame
+    std::vector<std::vector<std::size_t>> fSlices;
+    G4double fSliceZ0;
+    G4double fSliceWidth;
+
+    std::unique_ptr<G4Navigator> fNavigator;
+    G4long fPoints;
+    G4long fLocated;
+};
+
+#endif
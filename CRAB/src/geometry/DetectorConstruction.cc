@@ -17,8 +17,11 @@
 #include "G4Trd.hh"
 #include "DetectorMessenger.hh"
 #include "GasBoxSD.hh"
+#include "SensorSD.hh"
 #include "DegradModel.hh"
 #include "GarfieldVUVPhotonModel.hh"
+#include "OpticalTransportModel.hh"
+#include "LensCameraModel.hh"
 #include "G4SDManager.hh"
 #include "G4Polyhedra.hh"
 #include "G4SubtractionSolid.hh"
@@ -27,6 +30,9 @@
 #include "G4MultiUnion.hh"
 #include "Visibilities.hh"
 #include "HexagonMeshTools.hh"
+#include "XenonProperties.hh"
+#include "G4UImanager.hh"
+#include "G4UIcommand.hh"
 
 
 
@@ -63,7 +69,13 @@ DetectorConstruction::DetectorConstruction(GasModelParameters* gmp) :
     ELyield_(970/cm),
     PMT1_Pos_(2.32*cm),
     PMT3_Pos_(3.52*cm),
-    HideCollimator_(true)
+    HideCollimator_(true),
+    lensRcurve_(2.83*cm), // radius of curvature of MgF2 Lens
+    lensLength_(4*mm),    // max lens length
+    imageDist_(7.945*cm), // Got from trial and error
+    camRadius_(12.7*mm),
+    camHalfLength_(0.5*mm),
+    gas_mat(nullptr)
 {
     detectorMessenger = new DetectorMessenger(this);
 }
@@ -76,6 +88,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct(){
     
     //Materials
     G4Material *gxe    = materials::GXe(gas_pressure_,68);
+    gas_mat = gxe;
     G4Material *MgF2   = materials::MgF2();
     G4Material *Steel  = materials::Steel();
     G4Material *PEEK  = materials::PEEK();
@@ -109,11 +122,11 @@ G4VPhysicalVolume* DetectorConstruction::Construct(){
     G4LogicalVolume* MgF2_window_logic= new G4LogicalVolume(MgF2_window_solid, MgF2, "MgF2_WINDOW");
 
     // lens
-    const G4double lensRcurve (2.83*cm); // radius of curvature of MgF2 Lens  
+    const G4double lensRcurve (lensRcurve_); // radius of curvature of MgF2 Lens  
     const G4ThreeVector posLensTubeIntersect (0.,0.,-lensRcurve);
 
     // Create lens from the intersection of a sphere and a cylinder
-    G4double maxLensLength = 4*mm;
+    G4double maxLensLength = lensLength_;
     G4Tubs* sLensTube = new G4Tubs("sLensSphereTube", 0, MgF2_window_diam_/2, maxLensLength, 0.,twopi); // 4 mm is the max lens length
     G4Orb* sLensOrb = new G4Orb("sLensSphere",lensRcurve);
     G4IntersectionSolid* sLens =  new G4IntersectionSolid("sLens",sLensTube,sLensOrb, 0, posLensTubeIntersect);
@@ -285,8 +298,8 @@ G4VPhysicalVolume* DetectorConstruction::Construct(){
     G4LogicalVolume * InsideThePMT_Tube_Logic1=new G4LogicalVolume(InsideThePMT_Tube_solid1,vacuum,InsideThePMT_Tube_solid1->GetName());
 
     // CAMERA WINDOW
-    G4double camHalfLength=0.5*mm;
-    G4double camRadius= 12.7*mm;
+    G4double camHalfLength=camHalfLength_;
+    G4double camRadius= camRadius_;
     G4VSolid* camSolid = new G4Tubs("camWindow",0.,camRadius,camHalfLength,0.,twopi);
     G4LogicalVolume* camLogical = new G4LogicalVolume(camSolid,MgF2,"camLogical");
 
@@ -468,7 +481,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct(){
 
     // Place the camera Make camLogical mother and photocathode daughter
     // G4double LensFocalDist = 6.34*cm; // Got from trial and erro
-    G4double ImageDist = 7.945*cm; // Got from trial and error
+    G4double ImageDist = imageDist_; // Got from trial and error
     G4VPhysicalVolume* camPhysical= new G4PVPlacement(0,  G4ThreeVector (0,0, (chamber_length/2 + chamber_thickn + ImageDist) - PMT_pos-LongPMTTubeOffset),camLogical,"camPhysical",InsideThePMT_Tube_Logic0, false,0,false);  
 
 
@@ -586,6 +599,10 @@ G4VPhysicalVolume* DetectorConstruction::Construct(){
     G4Region* regionGas = new G4Region("GasRegion");
     regionGas->AddRootLogicalVolume(gas_logic);
 
+    // The lens gets its own region for the thick-lens camera model
+    G4Region* regionLens = new G4Region("LensRegion");
+    regionLens->AddRootLogicalVolume(lensLogical);
+
 
     return labPhysical;
 
@@ -599,11 +616,49 @@ void DetectorConstruction::ConstructSDandField(){
     SDManager->AddNewDetector(myGasBoxSD);
     SetSensitiveDetector(gas_logic,myGasBoxSD);
 
+    // PMT photocathodes, on every thread so that the workers see PMT hits
+    SetSensitiveDetector(pmt1_->GetPhotocathodeLogicalVolume(), pmt1_->ConstructSD());
+    SetSensitiveDetector(pmt2_->GetPhotocathodeLogicalVolume(), pmt2_->ConstructSD());
+
     //These commands generate the four gas models and connect it to the GasRegion
     G4Region* region = G4RegionStore::GetInstance()->GetRegion("GasRegion");
     new DegradModel(fGasModelParameters,"DegradModel",region,this,myGasBoxSD);
     new GarfieldVUVPhotonModel(fGasModelParameters,"GarfieldVUVPhotonModel",region,this,myGasBoxSD);
+    new OpticalTransportModel(fGasModelParameters,"OpticalTransportModel",region,this);
+
+    G4Region* lensRegion = G4RegionStore::GetInstance()->GetRegion("LensRegion");
+    new LensCameraModel(fGasModelParameters,"LensCameraModel",lensRegion,this);
+
+}
+
+void DetectorConstruction::UpdateGasPressure(G4double pressure){
+    gas_pressure_ = pressure;
+
+    // Geometry not built yet, Construct() will use the new pressure
+    if (!gas_mat) return;
+
+    // The density of a G4Material is fixed, so make a copy at the new density
+    // and swap it into the volumes filled with the old gas. The geometry and the
+    // Garfield models are left untouched.
+    G4String name = "GXe_" + G4UIcommand::ConvertToString(pressure/bar) + "bar";
+    G4Material* gxe = G4Material::GetMaterial(name, false);
+    if (!gxe){
+        gxe = new G4Material(name, GXeDensity(pressure), gas_mat, kStateGas, gas_mat->GetTemperature(), pressure);
+        gxe->SetMaterialPropertiesTable(opticalprops::GXe(pressure, 68, sc_yield_, e_lifetime_));
+    }
+
+    G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+    for (auto lv : *lvStore){
+        if (lv->GetMaterial() == gas_mat)
+            lv->SetMaterial(gxe);
+    }
+    gas_mat = gxe;
+
+    G4cout << "DetectorConstruction: gas pressure set to " << pressure/bar << " bar, density "
+           << G4BestUnit(gxe->GetDensity(), "Volumic Mass") << G4endl;
 
+    // Rebuild the material-cuts couples and physics tables at the next run
+    G4UImanager::GetUIpointer()->ApplyCommand("/run/physicsModified");
 }
 
 void DetectorConstruction::AssignVisuals() {
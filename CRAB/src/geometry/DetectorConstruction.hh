@@ -57,14 +57,26 @@ class DetectorConstruction : public G4VUserDetectorConstruction {
     //Setters for the dimensions and environment variables of the setup
     inline void CheckOverlaps(G4bool co){checkOverlaps=co;};
     inline void SetGasPressure(G4double d){gas_pressure_=d;};
+    // Change the pressure after the geometry is built, e.g. between scan points
+    void UpdateGasPressure(G4double);
     inline void SetTemperature(G4double d){temperature=d;};
 
     inline G4double GetChamberR(){return chamber_diam/2.0/cm;};
     inline G4double GetChamberL(){return chamber_length/cm; }; 
-    inline G4double GetActiveR() {return Active_diam/2.0/cm; }; 
-    inline G4double GetActiveL() {return FielCageGap/cm; }; 
+    inline G4double GetActiveR() const {return Active_diam/2.0/cm; }; 
+    inline G4double GetActiveL() const {return FielCageGap/cm; }; 
     inline G4double GetGasPressure(){return gas_pressure_;};
     inline G4double GetTemperature(){return temperature;};
+    inline G4LogicalVolume* GetGasLogical(){return gas_logic;};
+    // Position and radius of the MgF2 windows on the axis (lens at +z, S1 window at -z), G4 units
+    inline G4double GetWindowZ() const {return chamber_length/2 + chamber_thickn;};
+    inline G4double GetWindowR() const {return MgF2_window_diam_/2.0;};
+    // Lens and camera, G4 units. The lens apex sits lensLength/2 behind the
+    // window position, the camera entrance face imageDist-camHalfLength behind it.
+    inline G4double GetLensRcurve(){return lensRcurve_;};
+    inline G4double GetLensThickness(){return lensLength_;};
+    inline G4double GetLensToCamera(){return imageDist_ - lensLength_/2.0 - camHalfLength_;};
+    inline G4double GetCameraR(){return camRadius_;};
   
   
  private:
@@ -111,7 +123,14 @@ class DetectorConstruction : public G4VUserDetectorConstruction {
 
     G4double FielCageGap;
 
+    G4double lensRcurve_;
+    G4double lensLength_;
+    G4double imageDist_;
+    G4double camRadius_;
+    G4double camHalfLength_;
+
     G4LogicalVolume* gas_logic;
+    G4Material* gas_mat;
 
 
 };
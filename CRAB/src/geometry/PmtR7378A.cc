@@ -30,7 +30,7 @@
 namespace pmt {
   using namespace CLHEP;
 
-  PmtR7378A::PmtR7378A()
+  PmtR7378A::PmtR7378A() : phcath_logic_(nullptr)
   {
 
   }
@@ -126,12 +126,9 @@ namespace pmt {
       new G4PVPlacement(0, G4ThreeVector(0.,0.,phcath_posz), phcath_logic,
       DetName, window_logic, false, 0, false);
 
-    // Sensitive detector
-    sensorsd::SensorSD* pmtsd = new sensorsd::SensorSD(SensDet);
-    pmtsd->SetDetectorVolumeDepth(2);
-    pmtsd->SetTimeBinning(100.*nanosecond);
-    G4SDManager::GetSDMpointer()->AddNewDetector(pmtsd);
-    phcath_logic->SetSensitiveDetector(pmtsd);
+    // The sensitive detector is attached per thread by ConstructSD
+    phcath_logic_ = phcath_logic;
+    sensDetName_ = SensDet;
 
 
     // OPTICAL SURFACES //////////////////////////////////////////////
@@ -221,4 +218,13 @@ namespace pmt {
   }
   
 
+  sensorsd::SensorSD* PmtR7378A::ConstructSD()
+  {
+    sensorsd::SensorSD* pmtsd = new sensorsd::SensorSD(sensDetName_);
+    pmtsd->SetDetectorVolumeDepth(2);
+    pmtsd->SetTimeBinning(100.*nanosecond);
+    G4SDManager::GetSDMpointer()->AddNewDetector(pmtsd);
+    return pmtsd;
+  }
+
 }
\ No newline at end of file
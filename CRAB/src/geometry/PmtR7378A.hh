@@ -12,6 +12,8 @@
 #include <G4ThreeVector.hh>
 #include <G4LogicalVolume.hh>
 
+namespace sensorsd { class SensorSD; }
+
 namespace pmt {
 
   /// Geometry model for the Hamamatsu R7378A photomultiplier (PMT).
@@ -33,6 +35,12 @@ namespace pmt {
 
     void Construct();
 
+    /// Creates the sensitive detector of the photocathode. Called from
+    /// ConstructSDandField so that every worker thread has its own.
+    sensorsd::SensorSD* ConstructSD();
+    /// Returns the photocathode, to attach the sensitive detector to
+    G4LogicalVolume* GetPhotocathodeLogicalVolume() const { return phcath_logic_; }
+
     void SetPMTName(G4String PMTName);
     G4String GetPMTName();
 
@@ -48,6 +56,8 @@ namespace pmt {
   private:
     G4double pmt_diam_, pmt_length_; ///< PMT dimensions
     G4LogicalVolume* logicVol_; ///< Pointer to the logical volume
+    G4LogicalVolume* phcath_logic_; ///< Photocathode
+    G4String sensDetName_; ///< Name of the photocathode sensitive detector
 
       G4String PmtName;
 
@@ -49,6 +49,7 @@ const SensorHit& SensorHit::operator=(const SensorHit& other)
   bin_size_  = other.bin_size_;
   position_  = other.position_;
   histogram_ = other.histogram_;
+  photons_   = other.photons_;
 
   return *this;
 }
@@ -75,7 +76,7 @@ void SensorHit::SetBinSize(G4double bin_size)
 
 
 
-void SensorHit::Fill(G4double time, G4int counts)
+void SensorHit::Fill(G4double time, G4double counts)
 {
   G4double time_bin = floor(time/bin_size_) * bin_size_;
   histogram_[time_bin] += counts;
@@ -14,6 +14,8 @@
 #include <G4Allocator.hh>
 #include <G4ThreeVector.hh>
 #include "tls.hh"
+#include <map>
+#include <vector>
 
 namespace sensorhit {
 
@@ -55,18 +57,26 @@ namespace sensorhit {
     /// while the histogram is empty (rebinning is not supported).
     void SetBinSize(G4double);
 
-    /// Adds counts to a given time bin
-    void Fill(G4double time, G4int counts=1);
+    /// Adds counts to a given time bin. Counts are the statistical
+    /// weights of the photons, 1 for an analog simulation.
+    void Fill(G4double time, G4double counts=1.);
 
-    const std::map<G4double, G4int>& GetHistogram() const;
+    const std::map<G4double, G4double>& GetHistogram() const;
+
+    /// Adds a detected photon with its exact arrival time, used by the digitiser
+    void AddPhoton(G4double time, G4double weight=1.);
+    /// Arrival times and weights of the detected photons
+    const std::vector<std::pair<G4double, G4double>>& GetPhotons() const;
 
   private:
     G4int pmt_id_;           ///< Detector ID number
     G4double bin_size_;      ///< Size of time bin
     G4ThreeVector position_; ///< Detector position
 
-    /// Sparse histogram with number of photons detected per time bin
-    std::map<G4double, G4int> histogram_;
+    /// Sparse histogram with (weighted) number of photons detected per time bin
+    std::map<G4double, G4double> histogram_;
+    /// Unbinned arrival times and weights
+    std::vector<std::pair<G4double, G4double>> photons_;
   };
 
 } // namespace sensorhit
@@ -98,9 +108,15 @@ namespace sensorhit {
   inline G4ThreeVector SensorHit::GetPosition() const { return position_; }
   inline void SensorHit::SetPosition(const G4ThreeVector& p) { position_ = p; }
 
-  inline const std::map<G4double, G4int>& SensorHit::GetHistogram() const
+  inline const std::map<G4double, G4double>& SensorHit::GetHistogram() const
   { return histogram_; }
 
+  inline void SensorHit::AddPhoton(G4double time, G4double weight)
+  { photons_.emplace_back(time, weight); }
+
+  inline const std::vector<std::pair<G4double, G4double>>& SensorHit::GetPhotons() const
+  { return photons_; }
+
 } // namespace sensorhit
 
 #endif
@@ -86,7 +86,8 @@ namespace sensorsd {
     }
 
     G4double time = step->GetPostStepPoint()->GetGlobalTime();
-    hit->Fill(time);
+    hit->Fill(time, step->GetTrack()->GetWeight());
+    hit->AddPhoton(time, step->GetTrack()->GetWeight());
 
     return true;
   }
@@ -46,6 +46,6 @@ DetectorMessenger::~DetectorMessenger() {
 
 void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValues) {
   if (command == setGasPressCmd)
-    detector->SetGasPressure(setGasPressCmd->GetNewDoubleValue(newValues));
+    detector->UpdateGasPressure(setGasPressCmd->GetNewDoubleValue(newValues));
   
 }
@@ -6,6 +6,7 @@
 #include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWithADouble.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
 #include "G4UIcmdWithoutParameter.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4PhysicalConstants.hh"
@@ -36,6 +37,96 @@ GasModelParametersMessenger::GasModelParametersMessenger(GasModelParameters* gm)
   setEL_FileCmd->SetDefaultValue(false);
 
   setCOMSOL_Path = new G4UIcmdWithAString("/gasModelParameters/geometry/COMSOL_Path", this);
+
+  GarfieldDir = new G4UIdirectory("/gasModelParameters/garfield/");
+  GarfieldDir->SetGuidance("Garfield field and gas controls, can be changed between runs");
+
+  fieldDriftCmd = new G4UIcmdWithADouble("/gasModelParameters/garfield/fieldDrift", this);
+  fieldDriftCmd->SetGuidance("Set the drift field in V/cm");
+  fieldDriftCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fieldLEMCmd = new G4UIcmdWithADouble("/gasModelParameters/garfield/fieldLEM", this);
+  fieldLEMCmd->SetGuidance("Set the EL field in V/cm");
+  fieldLEMCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  gapLEMCmd = new G4UIcmdWithADoubleAndUnit("/gasModelParameters/garfield/gapLEM", this);
+  gapLEMCmd->SetGuidance("Set the EL gap length");
+  gapLEMCmd->SetUnitCategory("Length");
+  gapLEMCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  gasFileCmd = new G4UIcmdWithAString("/gasModelParameters/garfield/gasFile", this);
+  gasFileCmd->SetGuidance("Set the Magboltz gas file to load from $CRABPATH/data/");
+  gasFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  cullElectronsCmd = new G4UIcmdWithABool("/gasModelParameters/garfield/cullElectrons", this);
+  cullElectronsCmd->SetGuidance("Do not drift electrons that cannot reach the EL region");
+  cullElectronsCmd->SetDefaultValue(true);
+  cullElectronsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  cullMarginCmd = new G4UIcmdWithADoubleAndUnit("/gasModelParameters/garfield/cullMargin", this);
+  cullMarginCmd->SetGuidance("Electrons further than this outside the field cage radius are not drifted");
+  cullMarginCmd->SetUnitCategory("Length");
+  cullMarginCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  driftTimeWindowCmd = new G4UIcmdWithADoubleAndUnit("/gasModelParameters/garfield/driftTimeWindow", this);
+  driftTimeWindowCmd->SetGuidance("Stop drift lines at this global time, 0 for no limit");
+  driftTimeWindowCmd->SetUnitCategory("Time");
+  driftTimeWindowCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  driftStepsCmd = new G4UIcmdWithAString("/gasModelParameters/garfield/driftSteps", this);
+  driftStepsCmd->SetGuidance("Distance steps of the electron drift: fixed (fine steps everywhere),");
+  driftStepsCmd->SetGuidance("auto (coarse where the field is uniform along z) or table (addDriftStepRegion)");
+  driftStepsCmd->SetCandidates("fixed auto table");
+  driftStepsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  driftStepCoarseCmd = new G4UIcmdWithADoubleAndUnit("/gasModelParameters/garfield/driftStepCoarse", this);
+  driftStepCoarseCmd->SetGuidance("Drift distance step where the field is uniform, auto mode");
+  driftStepCoarseCmd->SetUnitCategory("Length");
+  driftStepCoarseCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  driftStepFineCmd = new G4UIcmdWithADoubleAndUnit("/gasModelParameters/garfield/driftStepFine", this);
+  driftStepFineCmd->SetGuidance("Drift distance step near field changes (auto) and everywhere (fixed)");
+  driftStepFineCmd->SetUnitCategory("Length");
+  driftStepFineCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  addDriftStepRegionCmd = new G4UIcmdWith3VectorAndUnit("/gasModelParameters/garfield/addDriftStepRegion", this);
+  addDriftStepRegionCmd->SetGuidance("Add a z band with its drift distance step: zmin zmax step unit, table mode");
+  addDriftStepRegionCmd->SetUnitCategory("Length");
+  addDriftStepRegionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  OpticsDir = new G4UIdirectory("/gasModelParameters/optics/");
+  OpticsDir->SetGuidance("Optical photon transport in the gas");
+
+  fastOpticsCmd = new G4UIcmdWithABool("/gasModelParameters/optics/fastTransport", this);
+  fastOpticsCmd->SetGuidance("Move optical photons through the gas with the analytic straight-line model");
+  fastOpticsCmd->SetDefaultValue(false);
+  fastOpticsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  elBiasCmd = new G4UIcmdWithADouble("/gasModelParameters/optics/elBiasFraction", this);
+  elBiasCmd->SetGuidance("Fraction of EL photons emitted towards the lens and the S1 window, the rest is isotropic.");
+  elBiasCmd->SetGuidance("Biased photons carry the likelihood-ratio weight. 0 turns the biasing off.");
+  elBiasCmd->SetParameterName("elBiasFraction", false);
+  elBiasCmd->SetRange("elBiasFraction>=0. && elBiasFraction<1.");
+  elBiasCmd->SetDefaultValue(0.);
+  elBiasCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  lensModelCmd = new G4UIcmdWithABool("/gasModelParameters/optics/lensModel", this);
+  lensModelCmd->SetGuidance("Map photons entering the MgF2 lens onto the camera pixels with a thick-lens ray-transfer model");
+  lensModelCmd->SetDefaultValue(false);
+  lensModelCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  pixelPitchCmd = new G4UIcmdWithADoubleAndUnit("/gasModelParameters/optics/pixelPitch", this);
+  pixelPitchCmd->SetGuidance("Pixel pitch of the camera image of the lens model");
+  pixelPitchCmd->SetParameterName("pixelPitch", false);
+  pixelPitchCmd->SetUnitCategory("Length");
+  pixelPitchCmd->SetRange("pixelPitch>0.");
+  pixelPitchCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  cameraQECmd = new G4UIcmdWithADouble("/gasModelParameters/optics/cameraQE", this);
+  cameraQECmd->SetGuidance("Quantum efficiency of the camera in the lens model");
+  cameraQECmd->SetParameterName("cameraQE", false);
+  cameraQECmd->SetRange("cameraQE>=0. && cameraQE<=1.");
+  cameraQECmd->AvailableForStates(G4State_PreInit, G4State_Idle);
   
 }
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -48,6 +139,24 @@ GasModelParametersMessenger::~GasModelParametersMessenger() {
   delete setComsolCmd;
   delete setEL_FileCmd;
   delete setCOMSOL_Path;
+  delete GarfieldDir;
+  delete fieldDriftCmd;
+  delete fieldLEMCmd;
+  delete gapLEMCmd;
+  delete gasFileCmd;
+  delete cullElectronsCmd;
+  delete cullMarginCmd;
+  delete driftTimeWindowCmd;
+  delete driftStepsCmd;
+  delete driftStepCoarseCmd;
+  delete driftStepFineCmd;
+  delete addDriftStepRegionCmd;
+  delete OpticsDir;
+  delete fastOpticsCmd;
+  delete elBiasCmd;
+  delete lensModelCmd;
+  delete pixelPitchCmd;
+  delete cameraQECmd;
 
 }
 
@@ -67,4 +176,68 @@ void GasModelParametersMessenger::SetNewValue(G4UIcommand* command, G4String new
     if (command == setCOMSOL_Path)
       fGasModelParameters->SetCOMSOL_Path(newValues);
 
+    if (command == fieldDriftCmd){
+      fGasModelParameters->SetFieldDrift(fieldDriftCmd->GetNewDoubleValue(newValues));
+      fGasModelParameters->NewScanPoint();
+    }
+
+    if (command == fieldLEMCmd){
+      fGasModelParameters->SetFieldLEM(fieldLEMCmd->GetNewDoubleValue(newValues));
+      fGasModelParameters->NewScanPoint();
+    }
+
+    if (command == gapLEMCmd){
+      fGasModelParameters->SetGapLEM(gapLEMCmd->GetNewDoubleValue(newValues)/cm);
+      fGasModelParameters->NewScanPoint();
+    }
+
+    if (command == fastOpticsCmd)
+      fGasModelParameters->SetFastOptics(fastOpticsCmd->GetNewBoolValue(newValues));
+
+    if (command == elBiasCmd)
+      fGasModelParameters->SetELBiasFraction(elBiasCmd->GetNewDoubleValue(newValues));
+
+    if (command == lensModelCmd)
+      fGasModelParameters->SetLensModel(lensModelCmd->GetNewBoolValue(newValues));
+
+    if (command == pixelPitchCmd)
+      fGasModelParameters->SetPixelPitch(pixelPitchCmd->GetNewDoubleValue(newValues));
+
+    if (command == cameraQECmd)
+      fGasModelParameters->SetCameraQE(cameraQECmd->GetNewDoubleValue(newValues));
+
+    if (command == cullElectronsCmd)
+      fGasModelParameters->SetCullElectrons(cullElectronsCmd->GetNewBoolValue(newValues));
+
+    if (command == cullMarginCmd)
+      fGasModelParameters->SetCullMargin(cullMarginCmd->GetNewDoubleValue(newValues)/cm);
+
+    if (command == driftTimeWindowCmd)
+      fGasModelParameters->SetDriftTimeWindow(driftTimeWindowCmd->GetNewDoubleValue(newValues)/ns);
+
+    if (command == driftStepsCmd){
+      fGasModelParameters->SetDriftStepMode(newValues);
+      fGasModelParameters->NewScanPoint();
+    }
+
+    if (command == driftStepCoarseCmd){
+      fGasModelParameters->SetDriftStepCoarse(driftStepCoarseCmd->GetNewDoubleValue(newValues)/cm);
+      fGasModelParameters->NewScanPoint();
+    }
+
+    if (command == driftStepFineCmd){
+      fGasModelParameters->SetDriftStepFine(driftStepFineCmd->GetNewDoubleValue(newValues)/cm);
+      fGasModelParameters->NewScanPoint();
+    }
+
+    if (command == addDriftStepRegionCmd){
+      fGasModelParameters->AddDriftStepRegion(addDriftStepRegionCmd->GetNew3VectorValue(newValues)/cm);
+      fGasModelParameters->NewScanPoint();
+    }
+
+    if (command == gasFileCmd){
+      fGasModelParameters->SetGasFile(newValues);
+      fGasModelParameters->NewScanPoint();
+    }
+
 }
@@ -13,6 +13,7 @@ class G4UIcmdWithADoubleAndUnit;
 class G4UIcmdWithoutParameter;
 class G4UIcmdWithADouble;
 class G4UIcmdWithAnInteger;
+class G4UIcmdWith3VectorAndUnit;
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 /*! \class GasModelParametersMessenger*/
 /*! class derived from G4UImessenger*/
@@ -38,6 +39,26 @@ public:
     G4UIcmdWithABool* setEL_FileCmd;
 
     G4UIcmdWithAString* setCOMSOL_Path;
+
+    G4UIdirectory* GarfieldDir;
+    G4UIcmdWithADouble* fieldDriftCmd;
+    G4UIcmdWithADouble* fieldLEMCmd;
+    G4UIcmdWithADoubleAndUnit* gapLEMCmd;
+    G4UIcmdWithAString* gasFileCmd;
+    G4UIcmdWithABool* cullElectronsCmd;
+    G4UIcmdWithADoubleAndUnit* cullMarginCmd;
+    G4UIcmdWithADoubleAndUnit* driftTimeWindowCmd;
+    G4UIcmdWithAString* driftStepsCmd;
+    G4UIcmdWithADoubleAndUnit* driftStepCoarseCmd;
+    G4UIcmdWithADoubleAndUnit* driftStepFineCmd;
+    G4UIcmdWith3VectorAndUnit* addDriftStepRegionCmd;
+
+    G4UIdirectory* OpticsDir;
+    G4UIcmdWithABool* fastOpticsCmd;
+    G4UIcmdWithADouble* elBiasCmd;
+    G4UIcmdWithABool* lensModelCmd;
+    G4UIcmdWithADoubleAndUnit* pixelPitchCmd;
+    G4UIcmdWithADouble* cameraQECmd;
   
 };
 
@@ -69,6 +69,9 @@ class PhysicsListMessenger : public G4UImessenger {
   G4UIcmdWithAString *pListCmd;
   G4UIcmdWithADoubleAndUnit *lowLimitECmd;
   G4UIcmdWithoutParameter* addParamCmd;
+  G4UIcmdWithAString* tableCacheCmd;
+  G4UIcmdWithABool* nestCacheCmd;
+  G4UIcmdWithAnInteger* nestCompareCmd;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -9,6 +9,7 @@
 #include "G4UIcommand.hh"
 #include <fstream>
 #include "G4TransportationManager.hh"
+#include "G4PhysicalVolumeStore.hh"
 #include "G4DynamicParticle.hh"
 #include "G4RandomDirection.hh"
 #include "GasModelParameters.hh"
@@ -38,10 +39,7 @@ DegradModel::DegradModel(GasModelParameters* gmp, G4String modelName, G4Region*
 DegradModel::~DegradModel() {}
 
 G4bool DegradModel::IsApplicable(const G4ParticleDefinition& particleType) {
-    if (particleType.GetParticleName()=="e-")
-        return true;
-    
-    return false;
+    return fElectron(&particleType);
 }
 
 G4bool DegradModel::ModelTrigger(const G4FastTrack& fastTrack) {
@@ -49,8 +47,7 @@ G4bool DegradModel::ModelTrigger(const G4FastTrack& fastTrack) {
     
     if (id == 1){
         //  also require that only photoelectric effect electrons are tracked here.
-        if ( (fastTrack.GetPrimaryTrack()->GetCreatorProcess()->GetProcessName().find("phot") != std::string::npos) ||
-             (fastTrack.GetPrimaryTrack()->GetCreatorProcess()->GetProcessName().find("comp") != std::string::npos))
+        if (fCreator(fastTrack.GetPrimaryTrack()->GetCreatorProcess()))
             return true;
     }
   
@@ -117,6 +114,22 @@ void DegradModel::GetElectronsFromDegrad(G4FastStep& fastStep,G4ThreeVector degr
     inFile.open(fname,std::ifstream::in);
     
     G4cout<< "Working in "<<fname<<G4endl;
+
+    // Describe the gas once per geometry
+    G4LogicalVolume* gasLogic = detCon->GetGasLogical();
+    G4VPhysicalVolume* gasPhys = nullptr;
+    for (auto pv : *G4PhysicalVolumeStore::GetInstance()){
+        if (pv->GetLogicalVolume() == gasLogic){
+            gasPhys = pv;
+            break;
+        }
+    }
+    if (gasPhys && gasPhys != fActiveGas.GetGasVolume())
+        fActiveGas.Build(gasPhys, G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume());
+
+    std::vector<G4ThreeVector> points;
+    std::vector<G4double> times;
+    std::vector<G4bool> inside;
     
     nline=1;
     electronNumber=0;
@@ -143,6 +156,8 @@ void DegradModel::GetElectronsFromDegrad(G4FastStep& fastStep,G4ThreeVector degr
                 v.push_back(n); //o n é adicionado ao vector
             }
             
+            points.clear();
+            times.clear();
             for (i=0;i<v.size();i=i+7){
                 posXDegrad=v[i];
                 posYDegrad=v[i+1];
@@ -160,19 +175,18 @@ void DegradModel::GetElectronsFromDegrad(G4FastStep& fastStep,G4ThreeVector degr
                 time=timeDegrad*0.001+timeInitial;
                 
                 
-                G4ThreeVector myPoint;
-                myPoint.setX(posX);
-                myPoint.setY(posY);
-                myPoint.setZ(posZ);
-                
-                //Check in which Physical volume the point bellongs
-                G4Navigator* theNavigator= G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
-                
-                G4VPhysicalVolume* myVolume = theNavigator->LocateGlobalPointAndSetup(myPoint);
-              
-                G4String solidName=myVolume->GetName();
-                
-                if (G4StrUtil::contains(solidName,"FIELDCAGE") || G4StrUtil::contains(solidName,"GAS") ){
+                points.emplace_back(posX, posY, posZ);
+                times.push_back(time);
+            }
+
+            //Check which points are in the active gas, all at once
+            fActiveGas.Classify(points, inside);
+
+            for (size_t k=0;k<points.size();k++){
+                const G4ThreeVector& myPoint = points[k];
+                time = times[k];
+
+                if (inside[k]){
 
                     electronNumber++;
                     XenonHit* xh = new XenonHit();
@@ -200,6 +214,11 @@ void DegradModel::GetElectronsFromDegrad(G4FastStep& fastStep,G4ThreeVector degr
     }
     inFile.close();
     G4cout << "Number of initial electrons: " << electronNumber << G4endl;
+
+    G4long classified, located;
+    fActiveGas.TakeCounts(classified, located);
+    G4cout << "DegradModel: " << classified << " electron positions classified, "
+           << located << " of them with the navigator" << G4endl;
     
     
 }
@@ -12,6 +12,8 @@
 #include "G4VFastSimulationModel.hh"
 #include "GasModelParameters.hh"
 #include "GasBoxSD.hh"
+#include "FastSimTrigger.hh"
+#include "ActiveGasClassifier.hh"
 
 class G4VPhysicalVolume;
 class DetectorConstruction;
@@ -44,6 +46,13 @@ class DegradModel : public G4VFastSimulationModel {
     GasBoxSD* fGasBoxSD;
     G4bool processOccured;
 
+    fastsimtrigger::ParticleTrigger fElectron {fastsimtrigger::ParticleNames{{"e-"}}};
+    // Photoelectric and Compton electrons only
+    fastsimtrigger::CreatorTrigger fCreator {fastsimtrigger::ProcessNameFragments{{"phot", "comp"}}};
+
+    // Degrad electrons are kept in the gas and field cage
+    ActiveGasClassifier fActiveGas {{"FIELDCAGE", "GAS"}};
+
     char* crab_path; // Path to the root directory
  
   
@@ -50,26 +50,16 @@ DriftLineTrajectory::DriftLineTrajectory()
 DriftLineTrajectory::DriftLineTrajectory(DriftLineTrajectory &right)
   :G4Trajectory(right)
 {
-  fpPointsContainer = new DriftLineTrajectoryPointContainer();
-  for(size_t i=0;i<right.fpPointsContainer->size();++i) {
-      DriftLineTrajectoryPoint* rightPoint
-          = (DriftLineTrajectoryPoint*)((*(right.fpPointsContainer))[i]);
-      fpPointsContainer->push_back(new DriftLineTrajectoryPoint(*rightPoint));
-  }
+  fpPointsContainer = new DriftLineTrajectoryPointContainer(*right.fpPointsContainer);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DriftLineTrajectory::~DriftLineTrajectory() {
-	for(size_t i=0;i<fpPointsContainer->size();++i){
-		delete  (*fpPointsContainer)[i];
-	}
-	fpPointsContainer->clear();
-
 	delete fpPointsContainer;
 }
 
 
 void DriftLineTrajectory::AppendStep(G4ThreeVector pos, G4double t){
-		fpPointsContainer->push_back(new DriftLineTrajectoryPoint(pos,t));
+		fpPointsContainer->emplace_back(pos,t);
 }
@@ -40,8 +40,10 @@
 #include "G4Track.hh"
 #include "G4Step.hh"
 #include "G4SystemOfUnits.hh"
+#include "DriftLineTrajectoryPoint.hh"
 
-typedef std::vector<G4VTrajectoryPoint*> DriftLineTrajectoryPointContainer;
+// Points are held by value in one contiguous block rather than allocated one by one
+typedef std::vector<DriftLineTrajectoryPoint> DriftLineTrajectoryPointContainer;
 
 class DriftLineTrajectory : public G4Trajectory
 {
@@ -59,7 +61,7 @@ class DriftLineTrajectory : public G4Trajectory
     virtual int GetPointEntries() const
      { return fpPointsContainer->size(); };
     virtual G4VTrajectoryPoint* GetPoint(G4int i) const
-     { return (*fpPointsContainer)[i]; };
+     { return &(*fpPointsContainer)[i]; };
     inline G4double GetCharge() const
    { return +2.*eplus; }
   private:
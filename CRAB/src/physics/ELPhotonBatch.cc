@@ -0,0 +1,42 @@
+#include "ELPhotonBatch.hh"
+
+#include "Randomize.hh"
+#include "G4PhysicalConstants.hh"
+
+#include <algorithm>
+#include <cmath>
+
+void ELPhotonBatch::Resize(std::size_t n){
+    for (auto* v : {&x, &y, &z, &t, &dx, &dy, &dz, &px, &py, &pz}) v->resize(n);
+    weight.assign(n, 1.);
+}
+
+void ELPhotonBatch::NewKey(){
+    // Odd and with both halves filled, as the generator wants
+    std::uint64_t hi = (std::uint64_t)(G4UniformRand()*4294967296.);
+    std::uint64_t lo = (std::uint64_t)(G4UniformRand()*4294967296.);
+    fKey = (hi << 32) | lo | 1;
+}
+
+void ELPhotonBatch::SampleIsotropic(){
+    NewKey();
+
+    const std::size_t n = Size();
+    G4double* ux = dx.data(); G4double* uy = dy.data(); G4double* uz = dz.data();
+    G4double* ex = px.data(); G4double* ey = py.data(); G4double* ez = pz.data();
+    for (std::size_t i = 0; i < n; i++){
+        const G4double cosTheta = 1. - 2.*Uniform(3*i);
+        const G4double sinTheta = std::sqrt(std::max(0., 1. - cosTheta*cosTheta));
+        const G4double phi = twopi*Uniform(3*i + 1);
+        const G4double psi = twopi*Uniform(3*i + 2);
+        const G4double cosPhi = std::cos(phi), sinPhi = std::sin(phi);
+        const G4double cosPsi = std::cos(psi), sinPsi = std::sin(psi);
+        ux[i] = sinTheta*cosPhi;
+        uy[i] = sinTheta*sinPhi;
+        uz[i] = cosTheta;
+        // cosPsi e_theta + sinPsi e_phi
+        ex[i] = cosPsi*cosTheta*cosPhi - sinPsi*sinPhi;
+        ey[i] = cosPsi*cosTheta*sinPhi + sinPsi*cosPhi;
+        ez[i] = -cosPsi*sinTheta;
+    }
+}
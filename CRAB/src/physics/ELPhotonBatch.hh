@@ -0,0 +1,57 @@
+/*
+ * ELPhotonBatch.hh
+ *
+ * Structure-of-arrays buffers for the EL photons of one electron. Positions
+ * and times are filled by the model, directions and polarisations for the
+ * whole batch at once from a counter based generator (Squares, Widynski
+ * 2020). The generator draws no state from one photon to the next, so the
+ * loops have no dependency between iterations and the compiler can vectorise
+ * them. Every batch takes a fresh key from the Geant4 engine, so runs stay
+ * reproducible from the Geant4 seed.
+ */
+
+#ifndef ELPhotonBatch_h
+#define ELPhotonBatch_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+class ELPhotonBatch
+{
+public:
+    // Resize all buffers, weights reset to 1
+    void Resize(std::size_t n);
+    inline std::size_t Size() const { return x.size(); }
+
+    // Isotropic directions, polarisations perpendicular to them at a random angle
+    void SampleIsotropic();
+    // Fresh key from the Geant4 engine, done by SampleIsotropic()
+    void NewKey();
+
+    // Uniform in (0,1), the counter-th number of the current key
+    inline G4double Uniform(std::uint64_t counter) const {
+        return (Squares32(counter, fKey) + 0.5)*(1./4294967296.);
+    }
+
+    std::vector<G4double> x, y, z, t;       // mm, ns
+    std::vector<G4double> dx, dy, dz;       // direction
+    std::vector<G4double> px, py, pz;       // polarisation
+    std::vector<G4double> weight;
+
+private:
+    static inline std::uint32_t Squares32(std::uint64_t ctr, std::uint64_t key) {
+        std::uint64_t x, y, z;
+        y = x = ctr*key;
+        z = y + key;
+        x = x*x + y; x = (x >> 32) | (x << 32);
+        x = x*x + z; x = (x >> 32) | (x << 32);
+        x = x*x + y; x = (x >> 32) | (x << 32);
+        return (x*x + z) >> 32;
+    }
+
+    std::uint64_t fKey = 0x9e3779b97f4a7c15ULL;
+};
+
+#endif
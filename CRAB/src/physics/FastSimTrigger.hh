@@ -0,0 +1,92 @@
+/*
+ * FastSimTrigger.hh
+ *
+ * Trigger tables shared by the fast simulation models. ModelTrigger is called
+ * on every step of every applicable track, so the decision must not compare
+ * strings. A rule (particle names, creator process name fragments) is
+ * evaluated once per particle definition or process object, the answer is
+ * kept against its pointer and later calls are a few pointer comparisons.
+ * Pointers are resolved when first seen rather than at construction because
+ * the models are built before the worker physics lists and NEST defines
+ * thermalelectron late.
+ */
+
+#ifndef FastSimTrigger_h
+#define FastSimTrigger_h 1
+
+#include "G4ParticleDefinition.hh"
+#include "G4VProcess.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fastsimtrigger {
+
+    // Decision for each pointer seen so far, evaluated by Rule on a miss
+    template <class T, class Rule>
+    class PointerTable {
+        public:
+            explicit PointerTable(Rule rule) : rule_(rule), last_(nullptr), lastResult_(false) {}
+
+            inline G4bool operator()(const T* p) {
+                if (p == last_) return lastResult_;
+                for (const auto& e : table_){
+                    if (e.first == p){
+                        last_ = p;
+                        lastResult_ = e.second;
+                        return lastResult_;
+                    }
+                }
+                G4bool result = p ? rule_(*p) : false;
+                table_.emplace_back(p, result);
+                last_ = p;
+                lastResult_ = result;
+                return result;
+            }
+
+            inline void Clear() { table_.clear(); last_ = nullptr; }
+
+        private:
+            Rule rule_;
+            std::vector<std::pair<const T*, G4bool>> table_;
+            const T* last_;
+            G4bool lastResult_;
+    };
+
+    // Particles matching one of the given names
+    struct ParticleNames {
+        std::vector<G4String> names;
+        G4bool operator()(const G4ParticleDefinition& p) const {
+            for (const auto& n : names) if (p.GetParticleName() == n) return true;
+            return false;
+        }
+    };
+
+    // Processes whose name contains one of the fragments ("phot", "comp")
+    struct ProcessNameFragments {
+        std::vector<std::string> fragments;
+        G4bool operator()(const G4VProcess& p) const {
+            for (const auto& f : fragments)
+                if (p.GetProcessName().find(f) != std::string::npos) return true;
+            return false;
+        }
+    };
+
+    // Physical volumes whose name contains one of the fragments ("GAS")
+    struct VolumeNameFragments {
+        std::vector<std::string> fragments;
+        G4bool operator()(const G4VPhysicalVolume& v) const {
+            for (const auto& f : fragments)
+                if (v.GetName().find(f) != std::string::npos) return true;
+            return false;
+        }
+    };
+
+    typedef PointerTable<G4ParticleDefinition, ParticleNames> ParticleTrigger;
+    typedef PointerTable<G4VProcess, ProcessNameFragments> CreatorTrigger;
+    typedef PointerTable<G4VPhysicalVolume, VolumeNameFragments> VolumeTrigger;
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include "G4TransportationManager.hh"
 #include "G4DynamicParticle.hh"
 #include "G4RandomDirection.hh"
+#include "G4PhysicalConstants.hh"
 
 #include "globals.hh"
 #include "MediumMagboltz.hh"
@@ -34,12 +35,11 @@
 #include "S2Photon.hh"
 
 #include "G4AutoLock.hh"
+
+#include <algorithm>
 namespace{G4Mutex aMutex = G4MUTEX_INITIALIZER;}
 
 const static G4double torr = 1. / 760. * bar;
-const static G4double gapLEM = 0.7; //cm
-const static G4double fieldDrift = 438.0; // V/cm
-const static G4double fieldLEM   = 11400.0; // V/cm higher than 3k (as used for 2 bar) for 10 bar!
 
 G4double DetChamberL;
 G4double DetChamberR;
@@ -56,6 +56,15 @@ GarfieldVUVPhotonModel::GarfieldVUVPhotonModel(GasModelParameters* gmp, G4String
         G4VFastSimulationModel(modelName, envelope),detCon(dc),fGasBoxSD(sd) {
     thermalE=gmp->GetThermalEnergy();
     fGasModelParameters = gmp;
+    fScanPoint = gmp->GetScanPoint();
+    fGapLEM = gmp->GetGapLEM();
+    fFieldDrift = gmp->GetFieldDrift();
+    fFieldLEM = gmp->GetFieldLEM();
+    fCulledElectrons = 0;
+    fDriftElectrons = 0;
+    fDriftSteps = 0.;
+    fDriftStepsFixed = 0.;
+    fDriftStalled = 0;
     InitialisePhysics();
 
     G4OpBoundaryProcess* fBoundaryProcess = new G4OpBoundaryProcess();
@@ -67,9 +76,7 @@ GarfieldVUVPhotonModel::GarfieldVUVPhotonModel(GasModelParameters* gmp, G4String
 
 G4bool GarfieldVUVPhotonModel::IsApplicable(const G4ParticleDefinition& particleType) {
   //  std::cout << "GarfieldVUVPhotonModel::IsApplicable() particleType is " << particleType.GetParticleName() << std::endl;
-  if (particleType.GetParticleName()=="thermalelectron") // || particleType.GetParticleName()=="opticalphoton")
-    return true;
-  return false;
+  return fThermalElectron(&particleType);
         
         
 }
@@ -82,9 +89,7 @@ G4bool GarfieldVUVPhotonModel::ModelTrigger(const G4FastTrack& fastTrack){
   // Fill the S1 track information
   //S1Fill(fastTrack);
   
-  G4String particleName = fastTrack.GetPrimaryTrack()->GetParticleDefinition()->GetParticleName();
-
-   if (ekin<thermalE && particleName=="thermalelectron")
+   if (ekin<thermalE && fThermalElectron(fastTrack.GetPrimaryTrack()->GetParticleDefinition()))
     {
       return true;
     }
@@ -107,6 +112,10 @@ void GarfieldVUVPhotonModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fast
      EC, 2-Dec-2021.
 
    */
+    // Parameters were changed between runs, e.g. by a scan
+    if (fScanPoint != fGasModelParameters->GetScanPoint())
+      UpdateScanPoint();
+
     fastStep.SetNumberOfSecondaryTracks(1E3);
   
     // G4cout<<"HELLO Garfield"<<G4endl;
@@ -162,16 +171,35 @@ void GarfieldVUVPhotonModel::GenerateVUVPhotons(const G4FastTrack& fastTrack, G4
     // fSensor->ElectricField(x0,y0,z0, ef[0], ef[1], ef[2], medium, status);                                        
     // std::cout << "GVUVPM: E field in medium " << medium << " at " << x0<<","<<y0<<","<<z0 << " is: " << ef[0]<<","<<ef[1]<<","<<ef[2] << std::endl;
 
+    // The field sends electrons above the cathode away from the EL and it is
+    // purely along z, so electrons well outside the field cage never reach it
+    if (fGasModelParameters->GetbCullElectrons() &&
+        (z0 > FCTop || std::sqrt(x0*x0 + y0*y0) > DetActiveR/2.0 + fGasModelParameters->GetCullMargin())){
+      fCulledElectrons++;
+      fastStep.KillPrimaryTrack();
+      delete garfExcHitsCol;
+      return;
+    }
+
+    // Nothing drifting past the end of the readout window can give light in it
+    if (fGasModelParameters->GetDriftTimeWindow() > 0.)
+      fAvalancheMC->SetTimeWindow(0., fGasModelParameters->GetDriftTimeWindow());
+    else
+      fAvalancheMC->UnsetTimeWindow();
+
     // Need to get the AvalancheMC drift at the High-Field point in z, and then call fAvalanche-AvalancheElectron() to create excitations/VUVphotons.
-    fAvalancheMC->DriftElectron(x0,y0,z0,t0);
+    DriftElectron(x0,y0,z0,t0);
 
-    unsigned int n = fAvalancheMC->GetNumberOfDriftLinePoints();
+    unsigned int n = fDriftPoints.size();
     double xi,yi,zi,ti;
     //	std::cout << "Drift(): avalanchetracking, n DLTs is " << n << std::endl;
 
     // Get zi when in the beginning of the EL region
     for(unsigned int i=0;i<n;i++){
-      fAvalancheMC->GetDriftLinePoint(i,xi,yi,zi,ti);
+      xi = fDriftPoints[i][0];
+      yi = fDriftPoints[i][1];
+      zi = fDriftPoints[i][2];
+      ti = fDriftPoints[i][3];
         // std::cout << "GVUVPM: positions are " << xi<<"," <<yi<<","<<zi <<"," <<ti<< std::endl;
         
 
@@ -204,8 +232,8 @@ void GarfieldVUVPhotonModel::GenerateVUVPhotons(const G4FastTrack& fastTrack, G4
 }
 
 
-void ePiecewise (const double x, const double y, const double z,
-         double& ex, double& ey, double& ez) {
+void GarfieldVUVPhotonModel::ePiecewise (const double x, const double y, const double z,
+         double& ex, double& ey, double& ez) const {
 
     
     // Only want Ey component to the field
@@ -215,24 +243,24 @@ void ePiecewise (const double x, const double y, const double z,
 
     // Set ez for regions outside of the radius of the FC
     if ( std::sqrt(x*x + y*y) > DetActiveR/2.0){
-        ez = -fieldDrift; // Negative field will send them away from the LEM region
+        ez = -fFieldDrift; // Negative field will send them away from the LEM region
     }
 
     // Field past the cathode drift them away from the LEM with negative field
     if (z > FCTop)
-        ez = -fieldDrift;
+        ez = -fFieldDrift;
 
     // Drift region
     if (z <= FCTop)
-        ez = fieldDrift;
+        ez = fFieldDrift;
 
     // EL region
-    if (z <= ELPos && z > ELPos-gapLEM)
-        ez = fieldLEM;
+    if (z <= ELPos && z > ELPos-fGapLEM)
+        ez = fFieldLEM;
 
     // Drift towards the end cap
-    if (z <= ELPos - gapLEM)
-        ez = fieldDrift; 
+    if (z <= ELPos - fGapLEM)
+        ez = fFieldDrift; 
 
       // std::cout<<"ePiecewise: z, ez are [cm]: " << z << ", " << ez << std::endl;
  
@@ -268,11 +296,18 @@ void GarfieldVUVPhotonModel::InitialisePhysics(){
     }
 
     G4String gas_path(nexus_path);
-    gasFile = gas_path + "/data/Xenon_10Bar.gas";
+    gasFile = gas_path + "/data/" + fGasModelParameters->GetGasFile();
     G4cout << gasFile << G4endl;
     fMediumMagboltz->LoadGasFile(gasFile.c_str());
     std::cout << "Finished Loading in the gas file" << std::endl;
 
+    // The gas tables are stored in E/p, so the detector pressure can differ from the file
+    fMediumMagboltz->SetPressure(detCon->GetGasPressure()/atmosphere*760.); // Torr
+
+    fFieldDrift = fGasModelParameters->GetFieldDrift();
+    fFieldLEM   = fGasModelParameters->GetFieldLEM();
+    fGapLEM     = fGasModelParameters->GetGapLEM();
+
     // Initialize the gas
     fMediumMagboltz->Initialise(true);
 
@@ -339,10 +374,19 @@ void GarfieldVUVPhotonModel::InitialisePhysics(){
     fAvalancheMC = new Garfield::AvalancheMC(); // drift, not avalanche, to be fair.
     fAvalancheMC->SetSensor(fSensor);
     fAvalancheMC->SetTimeSteps(0.05); // nsec, per example
-    fAvalancheMC->SetDistanceSteps(2.e-2); // cm, 10x example
+    fAvalancheMC->SetDistanceSteps(fGasModelParameters->GetDriftStepFine()); // cm, 10x example
     fAvalancheMC->EnableDebugging(false); // way too much information. 
     fAvalancheMC->DisableAttachment(); // Currently getting warning messages about the attachment. You can supress those by switching this on.
 
+    // Drift area, restored after every banded drift
+    if (!fGasModelParameters->GetbComsol())
+        fSensor->GetArea(fAreaMin[0], fAreaMin[1], fAreaMin[2], fAreaMax[0], fAreaMax[1], fAreaMax[2]);
+    else {
+        fSensor->SetArea();
+        fSensor->GetArea(fAreaMin[0], fAreaMin[1], fAreaMin[2], fAreaMax[0], fAreaMax[1], fAreaMax[2]);
+    }
+    BuildDriftStepRegions();
+
 
     // Load in the events
     if (fGasModelParameters->GetbEL_File())
@@ -409,6 +453,199 @@ void GarfieldVUVPhotonModel::S1Fill(const G4FastTrack& ftrk)
 
 }
 
+void GarfieldVUVPhotonModel::UpdateScanPoint()
+{
+    // Only the parts depending on the scanned parameters are rebuilt. The field
+    // component reads the members below, so it is picked up directly.
+    fScanPoint = fGasModelParameters->GetScanPoint();
+
+    fFieldDrift = fGasModelParameters->GetFieldDrift();
+    fFieldLEM   = fGasModelParameters->GetFieldLEM();
+    fGapLEM     = fGasModelParameters->GetGapLEM();
+
+    G4AutoLock lock(&aMutex);
+
+    // Reload the Magboltz tables only when a different gas file was requested
+    G4String newGasFile = G4String(std::getenv("CRABPATH")) + "/data/" + fGasModelParameters->GetGasFile();
+    if (newGasFile != gasFile){
+        gasFile = newGasFile;
+        fMediumMagboltz->LoadGasFile(gasFile.c_str());
+        fMediumMagboltz->Initialise(true);
+    }
+
+    fMediumMagboltz->SetPressure(detCon->GetGasPressure()/atmosphere*760.); // Torr
+
+    if (fGasModelParameters->GetbComsol())
+        G4cout << "GarfieldVUVPhotonModel: COMSOL field map in use, drift/EL field settings only affect the EL yield" << G4endl;
+
+    G4cout << "GarfieldVUVPhotonModel: scan point " << fScanPoint << ", P [bar] " << detCon->GetGasPressure()/bar
+           << ", drift field [V/cm] " << fFieldDrift << ", EL field [V/cm] " << fFieldLEM
+           << ", EL gap [cm] " << fGapLEM << ", gas file " << gasFile << G4endl;
+
+    BuildDriftStepRegions();
+}
+
+void GarfieldVUVPhotonModel::BuildDriftStepRegions()
+{
+    fDriftStepRegions.clear();
+
+    const G4String mode = fGasModelParameters->GetDriftStepMode();
+    const G4double fine   = fGasModelParameters->GetDriftStepFine();
+    const G4double coarse = fGasModelParameters->GetDriftStepCoarse();
+    const G4double zmin = fAreaMin[2];
+    const G4double zmax = fAreaMax[2];
+
+    if (mode == "table"){
+        // Bands from the macro, clipped to the drift area. Gaps between them
+        // keep the fine step.
+        std::vector<DriftStepRegion> table;
+        for (const auto& r : fGasModelParameters->GetDriftStepRegions()){
+            G4double lo = std::max(std::min(r.x(), r.y()), zmin);
+            G4double hi = std::min(std::max(r.x(), r.y()), zmax);
+            if (hi > lo && r.z() > 0.)
+                table.push_back({lo, hi, r.z()});
+        }
+        std::sort(table.begin(), table.end(),
+                  [](const DriftStepRegion& a, const DriftStepRegion& b){ return a.zmin < b.zmin; });
+
+        G4double z = zmin;
+        for (const auto& r : table){
+            if (r.zmin > z) fDriftStepRegions.push_back({z, r.zmin, fine});
+            G4double lo = std::max(r.zmin, z);
+            if (r.zmax > lo) fDriftStepRegions.push_back({lo, r.zmax, r.step});
+            z = std::max(z, r.zmax);
+        }
+        if (z < zmax) fDriftStepRegions.push_back({z, zmax, fine});
+    }
+    else if (mode == "auto" && coarse > fine){
+        // Ez on the axis in cells of one coarse step. A cell over which the
+        // field changes by more than 1% gets the fine step, and so do its
+        // neighbours, so the electron is on fine steps before it gets there.
+        const G4int nCells = std::max(1, G4int(std::ceil((zmax - zmin)/coarse)));
+        const G4double cell = (zmax - zmin)/nCells;
+        const G4int nSamples = 4;
+
+        std::vector<G4double> ez(nCells*nSamples + 1);
+        for (std::size_t i = 0; i < ez.size(); i++){
+            G4double ex = 0., ey = 0.;
+            Garfield::Medium* medium = nullptr;
+            int status = 0;
+            fSensor->ElectricField(0., 0., zmin + i*cell/nSamples, ex, ey, ez[i], medium, status);
+            if (status != 0) ez[i] = 0.;
+        }
+
+        std::vector<G4bool> fineCell(nCells, false);
+        for (G4int c = 0; c < nCells; c++){
+            G4double lo = ez[c*nSamples], hi = lo;
+            for (G4int s = 1; s <= nSamples; s++){
+                lo = std::min(lo, ez[c*nSamples + s]);
+                hi = std::max(hi, ez[c*nSamples + s]);
+            }
+            G4double scale = std::max(std::abs(lo), std::abs(hi));
+            if (scale > 0. && hi - lo > 0.01*scale) fineCell[c] = true;
+        }
+        std::vector<G4bool> widened(fineCell);
+        for (G4int c = 0; c < nCells; c++){
+            if (!fineCell[c]) continue;
+            if (c > 0) widened[c - 1] = true;
+            if (c + 1 < nCells) widened[c + 1] = true;
+        }
+
+        for (G4int c = 0; c < nCells; c++){
+            G4double step = widened[c] ? fine : coarse;
+            G4double lo = zmin + c*cell;
+            G4double hi = (c + 1 == nCells) ? zmax : lo + cell;
+            if (!fDriftStepRegions.empty() && fDriftStepRegions.back().step == step)
+                fDriftStepRegions.back().zmax = hi;
+            else
+                fDriftStepRegions.push_back({lo, hi, step});
+        }
+    }
+
+    // Fixed steps, or nothing to gain
+    if (fDriftStepRegions.empty())
+        fDriftStepRegions.push_back({zmin, zmax, fine});
+
+    if (fDriftStepRegions.size() > 1){
+        G4cout << "GarfieldVUVPhotonModel: drift steps (" << mode << ")" << G4endl;
+        for (const auto& r : fDriftStepRegions)
+            G4cout << "  z [cm] " << r.zmin << " to " << r.zmax << ", step [cm] " << r.step << G4endl;
+    }
+}
+
+void GarfieldVUVPhotonModel::DriftElectron(G4double x0, G4double y0, G4double z0, G4double t0)
+{
+    fDriftPoints.clear();
+    const G4double fine = fGasModelParameters->GetDriftStepFine();
+
+    // One band: a single drift over the whole area as before
+    if (fDriftStepRegions.size() == 1){
+        fAvalancheMC->SetDistanceSteps(fDriftStepRegions[0].step);
+        fAvalancheMC->DriftElectron(x0, y0, z0, t0);
+        for (std::size_t i = 0; i < fAvalancheMC->GetNumberOfDriftLinePoints(); i++){
+            std::array<G4double, 4> p;
+            fAvalancheMC->GetDriftLinePoint(i, p[0], p[1], p[2], p[3]);
+            fDriftPoints.push_back(p);
+        }
+    }
+    else {
+        // The sensor area is narrowed to the band, AvalancheMC stops on its
+        // boundary and the drift goes on from just inside the band it entered,
+        // so that the restart point is not on the edge of the new area
+        const G4double eps = 1.e-6; // cm
+        auto band = std::find_if(fDriftStepRegions.begin(), fDriftStepRegions.end(),
+                                 [z0](const DriftStepRegion& r){ return z0 < r.zmax; });
+        if (band == fDriftStepRegions.end()) band = fDriftStepRegions.end() - 1;
+
+        G4double x = x0, y = y0, z = z0, t = t0;
+        for (G4int stage = 0; stage < 1000; stage++){
+            fSensor->SetArea(fAreaMin[0], fAreaMin[1], band->zmin, fAreaMax[0], fAreaMax[1], band->zmax);
+            fAvalancheMC->SetDistanceSteps(band->step);
+            fAvalancheMC->DriftElectron(x, y, z, t);
+
+            const std::size_t n = fAvalancheMC->GetNumberOfDriftLinePoints();
+            for (std::size_t i = fDriftPoints.empty() ? 0 : 1; i < n; i++){
+                std::array<G4double, 4> p;
+                fAvalancheMC->GetDriftLinePoint(i, p[0], p[1], p[2], p[3]);
+                fDriftPoints.push_back(p);
+            }
+            // No step in this band, the rest of the drift line is lost
+            if (n < 2){
+                fDriftStalled++;
+                break;
+            }
+
+            // Left the band through its bottom or top into the next one?
+            const auto& last = fDriftPoints.back();
+            if (last[2] <= band->zmin + eps && band != fDriftStepRegions.begin()){
+                --band;
+                z = std::min(last[2], band->zmax) - eps;
+            }
+            else if (last[2] >= band->zmax - eps && band + 1 != fDriftStepRegions.end()){
+                ++band;
+                z = std::max(last[2], band->zmin) + eps;
+            }
+            else
+                break;
+            x = last[0]; y = last[1]; t = last[3];
+        }
+        fSensor->SetArea(fAreaMin[0], fAreaMin[1], fAreaMin[2], fAreaMax[0], fAreaMax[1], fAreaMax[2]);
+    }
+
+    // Steps taken, and an estimate of the steps of the fine fixed step over the same path
+    if (fDriftPoints.empty()) return;
+    fDriftElectrons++;
+    fDriftSteps += fDriftPoints.size() - 1;
+    G4double length = 0.;
+    for (std::size_t i = 1; i < fDriftPoints.size(); i++){
+        G4double dx = fDriftPoints[i][0] - fDriftPoints[i-1][0];
+        G4double dy = fDriftPoints[i][1] - fDriftPoints[i-1][1];
+        G4double dz = fDriftPoints[i][2] - fDriftPoints[i-1][2];
+        length += std::sqrt(dx*dx + dy*dy + dz*dz);
+    }
+    fDriftStepsFixed += std::ceil(length/fine);
+}
+
 void GarfieldVUVPhotonModel::Reset()
 {
   fSensor->ClearSignal();
@@ -431,7 +668,11 @@ Garfield::ComponentUser* GarfieldVUVPhotonModel::CreateSimpleGeometry(){
     // Make a component with analytic electric field
     Garfield::ComponentUser* componentDriftLEM = new Garfield::ComponentUser();
     componentDriftLEM->SetGeometry(geo);
-    componentDriftLEM->SetElectricField(ePiecewise);
+    // The field reads the settings of this model, so every thread drifts with its own
+    componentDriftLEM->SetElectricField([this](const double x, const double y, const double z,
+                                               double& ex, double& ey, double& ez){
+        ePiecewise(x, y, z, ex, ey, ez);
+    });
 
     // Printing pressure and temperature
     std::cout << "GarfieldVUVPhotonModel::buildBox(): Garfield mass density [g/cm3], pressure [Torr], temp [K]: " <<
@@ -449,42 +690,19 @@ void GarfieldVUVPhotonModel::MakeELPhotonsFromFile( G4FastStep& fastStep, G4doub
     G4int EL_event  = round(G4UniformRand()* (EL_events.size() - 1) );
     
     // Get the right EL array
-    std::vector<std::vector<G4double>> EL_profile = EL_profiles[EL_event];
-
-    // Now loop over and make the photons
-    G4int colHitsEntries = EL_profile.size();
-    // std::cout <<  colHitsEntries<< std::endl;
-    // colHitsEntries=1 ;
-
-    G4double tig4(0.);
-    
-    for (G4int i=0;i<colHitsEntries;i++){
-      GarfieldExcitationHit* newExcHit=new GarfieldExcitationHit();
-
-
-        // std::cout << xi << ", " <<  EL_profile[i][0]  << std::endl;
-      G4ThreeVector fakepos ( (xi+ EL_profile[i][0])*10., (yi+ EL_profile[i][1])*10., (zi+ EL_profile[i][2])*10. ); // 0 = x, 1 = y, 2 = z
-      newExcHit->SetPos(fakepos);
-     
-      
-      if (i % (colHitsEntries/colHitsEntries ) == 0){ // 50. Need to uncomment this condition, along with one in degradmodel.cc. EC, 2-Dec-2021.
-      
-        auto* optphot = S2Photon::OpticalPhotonDefinition();
-        
-        G4DynamicParticle VUVphoton(optphot,G4RandomDirection(), 7.2*eV);
-       
-        tig4 = ti + EL_profile[i][3]; // in nsec, t = index 3 in vector. Units are ns, so just add it on
-        // std::cout <<  "fakepos,time is " << fakepos[0] << ", " << fakepos[1] << ", " << fakepos[2] << ", " << tig4 << std::endl;
-        
-        newExcHit->SetTime(tig4);
-        fGasBoxSD->InsertGarfieldExcitationHit(newExcHit);
-        G4Track *newTrack=fastStep.CreateSecondaryTrack(VUVphoton, fakepos, tig4 ,false);
-        newTrack->SetPolarization(G4ThreeVector(0.,0.,1.0)); // Needs some pol'n, else we will only ever reflect at an OpBoundary. EC, 8-Aug-2022.
-        //	G4ProcessManager* pm= newTrack->GetDefinition()->GetProcessManager();
-        //	G4ProcessVectorfAtRestDoItVector = pm->GetAtRestProcessVector(typeDoIt);
-      }
-      counter[3]++;
+    const std::vector<std::vector<G4double>>& EL_profile = EL_profiles[EL_event];
+
+    // Positions and times of the photons, 0 = x, 1 = y, 2 = z, 3 = t [ns] in the profile
+    const std::size_t n = EL_profile.size();
+    fELBatch.Resize(n);
+    for (std::size_t i = 0; i < n; i++){
+        fELBatch.x[i] = (xi + EL_profile[i][0])*10.;
+        fELBatch.y[i] = (yi + EL_profile[i][1])*10.;
+        fELBatch.z[i] = (zi + EL_profile[i][2])*10.;
+        fELBatch.t[i] = ti + EL_profile[i][3];
     }
+
+    EmitELPhotons(fastStep);
     fastStep.KillPrimaryTrack();
 }
 
@@ -492,46 +710,112 @@ void GarfieldVUVPhotonModel::MakeELPhotonsFromFile( G4FastStep& fastStep, G4doub
 void GarfieldVUVPhotonModel::MakeELPhotonsSimple(G4FastStep& fastStep, G4double xi, G4double yi, G4double zi, G4double ti){
     
     G4int colHitsEntries= 0.0; //garfExcHitsCol->entries();
-    //	G4cout<<"GarfExcHits entries "<<colHitsEntries<<G4endl; // This one is not cumulative.
 
-    const G4double YoverP = 140.*fieldLEM/(detCon->GetGasPressure()/torr) - 116.; // yield/cm/bar, with P in Torr ... JINST 2 p05001 (2007).
-    colHitsEntries = YoverP * detCon->GetGasPressure()/bar * gapLEM; // with P in bar this time.
+    const G4double YoverP = 140.*fFieldLEM/(detCon->GetGasPressure()/torr) - 116.; // yield/cm/bar, with P in Torr ... JINST 2 p05001 (2007).
+    colHitsEntries = YoverP * detCon->GetGasPressure()/bar * fGapLEM; // with P in bar this time.
     // colHitsEntries*=2; // Max val before G4 cant handle the memory anymore
     // colHitsEntries=1; // This is to turn down S2 so the vis doesnt get overwelmed
 
     colHitsEntries *= (G4RandGauss::shoot(1.0,res));
     
-    G4double tig4(0.);
     const G4double vd(2.4); // mm/musec, https://arxiv.org/pdf/1902.05544.pdf. Pretty much flat at our E/p..
-    for (G4int i=0;i<colHitsEntries;i++){
-      GarfieldExcitationHit* newExcHit=new GarfieldExcitationHit();
+    // Photons evenly along the gap, ignoring diffusion in small LEM gap, EC 17-June-2022.
+    const std::size_t n = std::max(0, colHitsEntries);
+    fELBatch.Resize(n);
+    for (std::size_t i = 0; i < n; i++){
+        const G4double frac = G4double(i)/G4double(n);
+        fELBatch.x[i] = xi*10.;
+        fELBatch.y[i] = yi*10.;
+        fELBatch.z[i] = zi*10. - 10*fGapLEM*frac;
+        fELBatch.t[i] = ti + frac*fGapLEM*10./vd*1E3; // in nsec (fGapLEM is in cm)
+    }
 
-      G4ThreeVector fakepos (xi*10,yi*10.,zi*10.-10*gapLEM*float(i)/float(colHitsEntries)); /// ignoring diffusion in small LEM gap, EC 17-June-2022.
-      newExcHit->SetPos(fakepos);
-     
-      
-      if (i % (colHitsEntries/colHitsEntries ) == 0){ // 50. Need to uncomment this condition, along with one in degradmodel.cc. EC, 2-Dec-2021.
-      
-        auto* optphot = S2Photon::OpticalPhotonDefinition();
-        
-        G4DynamicParticle VUVphoton(optphot,G4RandomDirection(), 7.2*eV);
-       
+    EmitELPhotons(fastStep);
+    fastStep.KillPrimaryTrack();
 
-        /// std::cout <<  "fakepos,time is " << fakepos[0] << ", " << fakepos[1] << ", " << fakepos[2] << ", " << ti << std::endl;
-       
+}
 
-        tig4 = ti + float(i)/float(colHitsEntries)*gapLEM*10./vd*1E3; // in nsec (gapLEM is in cm). Still ignoring diffusion in small LEM.
-        //	    std::cout << "VUV photon time [nsec]: " << tig4 << std::endl;
-        
-        newExcHit->SetTime(tig4);
+
+void GarfieldVUVPhotonModel::EmitELPhotons(G4FastStep& fastStep){
+
+    const std::size_t n = fELBatch.Size();
+
+    // Biased emission depends on the position, those directions are drawn one by one
+    if (fGasModelParameters->GetELBiasFraction() > 0.){
+        fELBatch.NewKey();
+        for (std::size_t i = 0; i < n; i++){
+            G4ThreeVector dir = SampleELDirection(G4ThreeVector(fELBatch.x[i], fELBatch.y[i], fELBatch.z[i]), fELBatch.weight[i]);
+            G4ThreeVector pol = dir.orthogonal().unit();
+            pol.rotate(twopi*fELBatch.Uniform(i), dir);
+            fELBatch.dx[i] = dir.x(); fELBatch.dy[i] = dir.y(); fELBatch.dz[i] = dir.z();
+            fELBatch.px[i] = pol.x(); fELBatch.py[i] = pol.y(); fELBatch.pz[i] = pol.z();
+        }
+    }
+    else
+        fELBatch.SampleIsotropic();
+
+    auto* optphot = S2Photon::OpticalPhotonDefinition();
+    for (std::size_t i = 0; i < n; i++){
+        G4ThreeVector pos(fELBatch.x[i], fELBatch.y[i], fELBatch.z[i]);
+
+        GarfieldExcitationHit* newExcHit=new GarfieldExcitationHit();
+        newExcHit->SetPos(pos);
+        newExcHit->SetTime(fELBatch.t[i]);
         fGasBoxSD->InsertGarfieldExcitationHit(newExcHit);
-        G4Track *newTrack=fastStep.CreateSecondaryTrack(VUVphoton, fakepos, tig4 ,false);
-        newTrack->SetPolarization(G4ThreeVector(0.,0.,1.0)); // Needs some pol'n, else we will only ever reflect at an OpBoundary. EC, 8-Aug-2022.
-        //	G4ProcessManager* pm= newTrack->GetDefinition()->GetProcessManager();
-        //	G4ProcessVectorfAtRestDoItVector = pm->GetAtRestProcessVector(typeDoIt);
-      }
-      counter[3]++;
+
+        G4DynamicParticle VUVphoton(optphot, G4ThreeVector(fELBatch.dx[i], fELBatch.dy[i], fELBatch.dz[i]), 7.2*eV);
+        G4Track *newTrack=fastStep.CreateSecondaryTrack(VUVphoton, pos, fELBatch.t[i], false);
+        // Needs some pol'n, else we will only ever reflect at an OpBoundary. EC, 8-Aug-2022.
+        newTrack->SetPolarization(G4ThreeVector(fELBatch.px[i], fELBatch.py[i], fELBatch.pz[i]));
+        newTrack->SetWeight(fELBatch.weight[i]);
     }
-    fastStep.KillPrimaryTrack();
+    counter[3] += n;
+}
 
-}
\ No newline at end of file
+
+G4ThreeVector GarfieldVUVPhotonModel::SampleELDirection(const G4ThreeVector& pos, G4double& weight){
+
+    weight = 1.;
+    const G4double f = fGasModelParameters->GetELBiasFraction();
+    if (f <= 0.)
+        return G4RandomDirection();
+
+    // Cones from the emission point to the lens (+z) and the S1 window (-z)
+    const G4double zWin = detCon->GetWindowZ();
+    const G4double rWin = detCon->GetWindowR();
+    G4ThreeVector axis[2];
+    G4double cosMax[2], solidAngle[2];
+    for (G4int k = 0; k < 2; k++){
+        G4ThreeVector toWindow = G4ThreeVector(0., 0., k == 0 ? zWin : -zWin) - pos;
+        G4double d = toWindow.mag();
+        axis[k] = toWindow.unit();
+        // Half-opening angle of a sphere of radius rWin around the window centre,
+        // covers the disk for any emission point off the axis
+        cosMax[k] = d > rWin ? std::sqrt(1. - rWin*rWin/(d*d)) : -1.;
+        solidAngle[k] = twopi*(1. - cosMax[k]);
+    }
+
+    G4ThreeVector dir;
+    G4double u = G4UniformRand();
+    if (u < 1. - f)
+        dir = G4RandomDirection();
+    else {
+        // Pick one of the two cones with equal probability, uniform inside it
+        G4int k = (u < 1. - f/2.) ? 0 : 1;
+        G4double cosTheta = 1. - G4UniformRand()*(1. - cosMax[k]);
+        G4double sinTheta = std::sqrt(std::max(0., 1. - cosTheta*cosTheta));
+        G4double phi = twopi*G4UniformRand();
+        dir = G4ThreeVector(sinTheta*std::cos(phi), sinTheta*std::sin(phi), cosTheta);
+        dir.rotateUz(axis[k]);
+    }
+
+    // Mixture density of the sampled direction relative to the isotropic one
+    G4double density = (1. - f)/(4.*pi);
+    for (G4int k = 0; k < 2; k++){
+        if (dir.dot(axis[k]) >= cosMax[k])
+            density += f/2./solidAngle[k];
+    }
+    weight = 1./(4.*pi*density);
+
+    return dir;
+}
@@ -36,6 +36,8 @@
 #include "G4OpWLS.hh"
 #include "G4OpBoundaryProcess.hh"
 #include "FileHandling.hh"
+#include "FastSimTrigger.hh"
+#include "ELPhotonBatch.hh"
 
 #include "G4VFastSimulationModel.hh"
 #include "Medium.hh"
@@ -47,6 +49,8 @@
 
 #include "TrackHeed.hh"
 
+#include <array>
+
 class GasModelParameters;
 class DetectorConstruction;
 class GasBoxSD;
@@ -68,6 +72,17 @@ public:
     virtual void DoIt(const G4FastTrack&, G4FastStep&);
     void GenerateVUVPhotons(const G4FastTrack& fastTrack, G4FastStep& fastStep,G4ThreeVector garfPos,G4double garfTime);
         void Reset();
+    // Electrons skipped since the last call, see GasModelParameters::SetCullElectrons
+    inline G4int TakeCulledElectrons(){G4int n = fCulledElectrons; fCulledElectrons = 0; return n;};
+    // Drifted electrons, their AvalancheMC steps, an estimate of the steps the
+    // fine fixed step would have taken over the same paths, and the banded
+    // drifts that stopped without a step, since the last call
+    inline void TakeDriftSteps(G4int& electrons, G4double& steps, G4double& fixedSteps, G4int& stalled){
+      electrons = fDriftElectrons; steps = fDriftSteps; fixedSteps = fDriftStepsFixed; stalled = fDriftStalled;
+      fDriftElectrons = 0; fDriftSteps = 0.; fDriftStepsFixed = 0.; fDriftStalled = 0;
+    };
+    // Pick up field, gap, gas file and pressure changes made between runs
+    void UpdateScanPoint();
     G4ThreeVector garfPos;
     G4double garfTime;
     
@@ -86,6 +101,39 @@ private:
     void InitialisePhysics();
     void S1Fill(const G4FastTrack& );
 
+    // Piecewise Ez of the simple geometry, from the settings below
+    void ePiecewise(const double x, const double y, const double z, double& ex, double& ey, double& ez) const;
+
+    // z band of the chamber drifted with one AvalancheMC distance step, cm
+    struct DriftStepRegion {
+      G4double zmin, zmax, step;
+    };
+
+    // Fill fDriftStepRegions from the drift step mode, see GasModelParameters::SetDriftStepMode
+    void BuildDriftStepRegions();
+
+    // Drift an electron band by band with the step of each band, the points
+    // of the whole drift line go to fDriftPoints
+    void DriftElectron(G4double x0, G4double y0, G4double z0, G4double t0);
+
+    std::vector<DriftStepRegion> fDriftStepRegions;
+    std::vector<std::array<G4double, 4>> fDriftPoints; // x, y, z, t
+    G4double fAreaMin[3];
+    G4double fAreaMax[3];
+    G4int fDriftElectrons;
+    G4double fDriftSteps;
+    G4double fDriftStepsFixed;
+    G4int fDriftStalled;
+
+    // Emission direction of an EL photon at pos. With elBiasFraction > 0 part
+    // of the photons go into the cones subtended by the lens and the S1 window,
+    // weight is then the likelihood ratio isotropic/sampled density.
+    G4ThreeVector SampleELDirection(const G4ThreeVector& pos, G4double& weight);
+
+    // Sample directions for the positions and times in fELBatch and create its photons
+    void EmitELPhotons(G4FastStep& fastStep);
+    ELPhotonBatch fELBatch;
+
     G4String gasFile;
     G4String ionMobFile;
   
@@ -93,6 +141,7 @@ private:
     G4ThreeVector myPoint;
     G4double time;
     G4double thermalE;
+    fastsimtrigger::ParticleTrigger fThermalElectron {fastsimtrigger::ParticleNames{{"thermalelectron"}}};
     //degradPhysics* fdegradPhysics;
 
     Garfield::MediumMagboltz* fMediumMagboltz;
@@ -117,6 +166,12 @@ private:
     filehandler::FileHandling FileHandler;
 
     GasModelParameters* fGasModelParameters;
+    G4int fScanPoint;
+    // Taken from GasModelParameters in InitialisePhysics() and UpdateScanPoint()
+    G4double fGapLEM;     // cm
+    G4double fFieldDrift; // V/cm
+    G4double fFieldLEM;   // V/cm
+    G4int fCulledElectrons;
 
 
 };
@@ -3,6 +3,23 @@
 #include "GasModelParametersMessenger.hh"
 #include "DetectorConstruction.hh"
 
-GasModelParameters::GasModelParameters(){
+GasModelParameters::GasModelParameters():
+	fieldDrift_(438.0),
+	fieldLEM_(11400.0), // higher than 3k (as used for 2 bar) for 10 bar!
+	gapLEM_(0.7),
+	gasFile_("Xenon_10Bar.gas"),
+	scanPoint_(0),
+	useFastOptics_(false),
+	elBiasFraction_(0.),
+	useLensModel_(false),
+	pixelPitch_(0.1*mm),
+	cameraQE_(1.),
+	cullElectrons_(false),
+	cullMargin_(1.0),
+	driftTimeWindow_(0.),
+	driftStepMode_("fixed"),
+	driftStepCoarse_(0.2),
+	driftStepFine_(2.e-2)
+{
 	fMessenger = new GasModelParametersMessenger(this);
 }
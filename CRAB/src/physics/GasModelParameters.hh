@@ -3,7 +3,9 @@
 
 #include "G4SystemOfUnits.hh"
 #include "G4String.hh"
+#include "G4ThreeVector.hh"
 #include <map>
+#include <vector>
 
 class DegradModel;
 class GasModelParametersMessenger;
@@ -25,6 +27,55 @@ class GasModelParameters{
 	inline bool GetbComsol(){return useComsol_;};
 	inline bool GetbEL_File(){return useEL_File_;};
 	inline G4String GetCOMSOL_Path(){return COMSOL_Path_;};
+	inline void SetFastOptics(G4bool b){useFastOptics_=b;};
+	inline G4bool GetbFastOptics(){return useFastOptics_;};
+	// Fraction of EL photons emitted into cones towards the sensors
+	inline void SetELBiasFraction(G4double d){elBiasFraction_=d;};
+	inline G4double GetELBiasFraction(){return elBiasFraction_;};
+	// Thick-lens camera: map photons entering the lens onto camera pixels with a ray-transfer matrix
+	inline void SetLensModel(G4bool b){useLensModel_=b;};
+	inline G4bool GetbLensModel(){return useLensModel_;};
+	inline void SetPixelPitch(G4double d){pixelPitch_=d;};
+	inline G4double GetPixelPitch(){return pixelPitch_;};
+	inline void SetCameraQE(G4double d){cameraQE_=d;};
+	inline G4double GetCameraQE(){return cameraQE_;};
+
+	// Garfield field and gas settings, previously constants in GarfieldVUVPhotonModel
+	inline void SetFieldDrift(G4double d){fieldDrift_=d;};
+	inline void SetFieldLEM(G4double d){fieldLEM_=d;};
+	inline void SetGapLEM(G4double d){gapLEM_=d;};
+	inline void SetGasFile(G4String s){gasFile_=s;};
+	inline G4double GetFieldDrift(){return fieldDrift_;};
+	inline G4double GetFieldLEM(){return fieldLEM_;};
+	inline G4double GetGapLEM(){return gapLEM_;};
+	inline G4String GetGasFile(){return gasFile_;};
+
+	// Electrons that cannot reach the EL region are not drifted: above the
+	// cathode, or further than cullMargin outside the field cage radius.
+	// Drift lines are also stopped at the end of the drift time window (0 = none).
+	inline void SetCullElectrons(G4bool b){cullElectrons_=b;};
+	inline G4bool GetbCullElectrons(){return cullElectrons_;};
+	inline void SetCullMargin(G4double d){cullMargin_=d;};
+	inline G4double GetCullMargin(){return cullMargin_;};
+	inline void SetDriftTimeWindow(G4double d){driftTimeWindow_=d;};
+	inline G4double GetDriftTimeWindow(){return driftTimeWindow_;};
+
+	// AvalancheMC distance steps: "fixed" uses fine steps everywhere, "auto" takes
+	// coarse steps where the field is uniform along z, "table" uses the regions
+	// added as (zmin, zmax, step) in cm
+	inline void SetDriftStepMode(G4String s){driftStepMode_=s;};
+	inline G4String GetDriftStepMode(){return driftStepMode_;};
+	inline void SetDriftStepCoarse(G4double d){driftStepCoarse_=d;};
+	inline G4double GetDriftStepCoarse(){return driftStepCoarse_;};
+	inline void SetDriftStepFine(G4double d){driftStepFine_=d;};
+	inline G4double GetDriftStepFine(){return driftStepFine_;};
+	inline void AddDriftStepRegion(G4ThreeVector r){driftStepRegions_.push_back(r);};
+	inline const std::vector<G4ThreeVector>& GetDriftStepRegions(){return driftStepRegions_;};
+
+	// Bumped whenever the parameters change after initialisation, the models
+	// compare it with their own copy and only rebuild what is needed
+	inline void NewScanPoint(){scanPoint_++;};
+	inline G4int GetScanPoint(){return scanPoint_;};
 
 	
 	private:
@@ -34,6 +85,26 @@ class GasModelParameters{
 	G4String COMSOL_Path_;
 	G4bool 	useEL_File_;
 	G4bool 	useComsol_;
+	G4bool 	useFastOptics_;
+	G4double elBiasFraction_;
+	G4bool   useLensModel_;
+	G4double pixelPitch_;
+	G4double cameraQE_;
+
+	G4double fieldDrift_; // V/cm
+	G4double fieldLEM_;   // V/cm
+	G4double gapLEM_;     // cm
+	G4String gasFile_;    // relative to $CRABPATH/data/
+	G4int scanPoint_;
+
+	G4bool   cullElectrons_;
+	G4double cullMargin_;      // cm
+	G4double driftTimeWindow_; // ns
+
+	G4String driftStepMode_;
+	G4double driftStepCoarse_; // cm
+	G4double driftStepFine_;   // cm
+	std::vector<G4ThreeVector> driftStepRegions_; // cm
 
 };
 
@@ -0,0 +1,108 @@
+#include "LensCameraModel.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Track.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4Material.hh"
+#include "Randomize.hh"
+
+#include "DetectorConstruction.hh"
+#include "S2Photon.hh"
+#include "Analysis.hh"
+#include "EventAction.hh"
+#include "G4EventManager.hh"
+
+LensCameraModel::LensCameraModel(GasModelParameters* gmp, G4String modelName, G4Region* envelope, DetectorConstruction* dc)
+    : G4VFastSimulationModel(modelName, envelope), fGasModelParameters(gmp), detCon(dc), fRindex(nullptr) {
+}
+
+G4bool LensCameraModel::IsApplicable(const G4ParticleDefinition& particleType) {
+    if (&particleType == S2Photon::OpticalPhoton() || &particleType == G4OpticalPhoton::OpticalPhoton())
+        return true;
+    return false;
+}
+
+G4bool LensCameraModel::ModelTrigger(const G4FastTrack& fastTrack) {
+    if (!fGasModelParameters->GetbLensModel())
+        return false;
+
+    // Only photons travelling towards the camera, the rest are left to Geant4
+    return fastTrack.GetPrimaryTrackLocalDirection().z() > 0.;
+}
+
+void LensCameraModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) {
+    const G4Track* track = fastTrack.GetPrimaryTrack();
+    counter[0]++;
+
+    if (!fRindex){
+        G4MaterialPropertiesTable* mpt = track->GetMaterial()->GetMaterialPropertiesTable();
+        fRindex = mpt ? mpt->GetProperty("RINDEX") : nullptr;
+        if (!fRindex)
+            G4Exception("[LensCameraModel]", "DoIt()", FatalException, "The lens material has no RINDEX");
+    }
+
+    // Lens frame: flat face at z = -thickness, apex of the spherical face at z = 0
+    G4ThreeVector pos = fastTrack.GetPrimaryTrackLocalPosition();
+    G4ThreeVector dir = fastTrack.GetPrimaryTrackLocalDirection();
+    const G4double t  = detCon->GetLensThickness();
+    const G4double Rc = detCon->GetLensRcurve();
+    const G4double n  = fRindex->Value(track->GetKineticEnergy());
+
+    // Ray heights and slopes in x and y at the flat face
+    G4double hx = pos.x() + (-t - pos.z())*dir.x()/dir.z();
+    G4double hy = pos.y() + (-t - pos.z())*dir.y()/dir.z();
+    G4double ux = dir.x()/dir.z();
+    G4double uy = dir.y()/dir.z();
+
+    // Refraction at the flat face, translation through the lens, refraction
+    // at the convex face (centre of curvature on the incoming side)
+    ux /= n;                      uy /= n;
+    hx += t*ux;                   hy += t*uy;
+    ux = n*ux - (n - 1.)/Rc*hx;   uy = n*uy - (n - 1.)/Rc*hy;
+
+    // Free flight to the camera plane
+    const G4double L = detCon->GetLensToCamera();
+    hx += L*ux;
+    hy += L*uy;
+
+    fastStep.KillPrimaryTrack();
+
+    if (hx*hx + hy*hy > detCon->GetCameraR()*detCon->GetCameraR()){
+        counter[1]++;
+        return;
+    }
+
+    // Counted like a photon reaching the camera volume in the SteppingAction
+    EventAction* eventAction = static_cast<EventAction*>(G4EventManager::GetEventManager()->GetUserEventAction());
+    if (eventAction) eventAction->AddCameraWeight(track->GetWeight());
+
+    if (G4UniformRand() > fGasModelParameters->GetCameraQE())
+        return;
+
+    const G4double pitch = fGasModelParameters->GetPixelPitch();
+    std::pair<G4int,G4int> pixel(std::floor(hx/pitch), std::floor(hy/pitch));
+    fImage[pixel] += track->GetWeight();
+    counter[2]++;
+}
+
+void LensCameraModel::FillImage(G4int event) {
+    if (fImage.empty()) return;
+
+    G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+    const G4double pitch = fGasModelParameters->GetPixelPitch();
+    G4int id = 6;
+    for (const auto& pixel : fImage){
+        analysisManager->FillNtupleDColumn(id,0, event);
+        analysisManager->FillNtupleIColumn(id,1, pixel.first.first);
+        analysisManager->FillNtupleIColumn(id,2, pixel.first.second);
+        analysisManager->FillNtupleDColumn(id,3, (pixel.first.first + 0.5)*pitch/mm);
+        analysisManager->FillNtupleDColumn(id,4, (pixel.first.second + 0.5)*pitch/mm);
+        analysisManager->FillNtupleDColumn(id,5, pixel.second);
+        analysisManager->AddNtupleRow(id);
+    }
+}
+
+void LensCameraModel::Reset() {
+    fImage.clear();
+}
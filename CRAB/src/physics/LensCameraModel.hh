@@ -0,0 +1,49 @@
+/*
+ * LensCameraModel.hh
+ *
+ * Optional fast path for the camera. Photons entering the MgF2 lens are not
+ * tracked through the boolean lens solid and the PMT tube, instead a paraxial
+ * thick-lens ray-transfer matrix (flat entrance face, spherical exit face,
+ * refractive index of MgF2 at the photon energy) maps them straight onto the
+ * camera plane. Hits are binned into pixels and summed per event, the image
+ * is written to the Image ntuple at the end of the event.
+ */
+
+#ifndef LensCameraModel_h
+#define LensCameraModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "G4MaterialPropertyVector.hh"
+#include "GasModelParameters.hh"
+
+#include <map>
+#include <vector>
+#include <utility>
+
+class DetectorConstruction;
+
+class LensCameraModel : public G4VFastSimulationModel
+{
+public:
+    LensCameraModel(GasModelParameters*, G4String, G4Region*, DetectorConstruction*);
+    ~LensCameraModel(){};
+
+    virtual G4bool IsApplicable(const G4ParticleDefinition&);
+    virtual G4bool ModelTrigger(const G4FastTrack&);
+    virtual void DoIt(const G4FastTrack&, G4FastStep&);
+
+    // Write the non-empty pixels of this event to the Image ntuple and clear them
+    void FillImage(G4int event);
+    void Reset();
+
+private:
+    GasModelParameters* fGasModelParameters;
+    DetectorConstruction* detCon;
+    G4MaterialPropertyVector* fRindex;
+
+    // Weighted counts per (ix, iy) pixel
+    std::map<std::pair<G4int,G4int>, G4double> fImage;
+    std::vector<G4long> counter {0,0,0}; // photons, outside the camera, detected
+};
+
+#endif
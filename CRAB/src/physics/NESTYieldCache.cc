@@ -0,0 +1,154 @@
+#include "NESTYieldCache.hh"
+
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Energy grid in log10(E/keV), nodes per decade
+const static double kLogEMin = -3.;
+const static double kLogEMax = 4.;
+const static int kPerDecade = 32;
+// Node spacing in log(1 + field/(V/cm)) and log(density/(g/cm3))
+const static double kFieldStep = 0.02;
+const static double kDensityStep = 0.01;
+
+G4bool NESTYieldCache::fEnabled = true;
+G4int NESTYieldCache::fCompareInterval = 1000;
+G4ThreadLocal NESTYieldCache* NESTYieldCache::fInstance = nullptr;
+
+NESTYieldCache::NESTYieldCache(VDetector* detector)
+    : NEST::NESTcalc(detector), fHits(0), fDirect(0), fCompared(0),
+      fPhotonDiffSum(0.), fElectronDiffSum(0.), fPhotonDiffMax(0.), fElectronDiffMax(0.),
+      fCachedTime(0.), fDirectTime(0.) {
+    fInstance = this;
+}
+
+NESTYieldCache::~NESTYieldCache() {
+    if (fInstance == this) fInstance = nullptr;
+}
+
+const NESTYieldCache::Table& NESTYieldCache::GetTable(NEST::INTERACTION_TYPE species, double A, double Z,
+                                                      const std::vector<double>& NuisParam,
+                                                      const std::vector<double>& ERYieldsParam, bool oldModelER,
+                                                      int fieldNode, int densityNode) {
+    Key key(int(species), A, Z, NuisParam, ERYieldsParam, oldModelER, fieldNode, densityNode);
+    auto it = fTables.find(key);
+    if (it != fTables.end()) return it->second;
+
+    const double field = std::exp(fieldNode*kFieldStep) - 1.;
+    const double density = std::exp(densityNode*kDensityStep);
+    const int nNodes = int((kLogEMax - kLogEMin)*kPerDecade) + 1;
+
+    Table& table = fTables[key];
+    table.nodes.resize(nNodes);
+    table.valid.resize(nNodes);
+    for (int i = 0; i < nNodes; i++){
+        double energy = std::pow(10., kLogEMin + double(i)/kPerDecade);
+        NEST::YieldResult r = NEST::NESTcalc::GetYields(species, energy, density, field, A, Z, NuisParam, ERYieldsParam, oldModelER);
+        Node& n = table.nodes[i];
+        n = {r.PhotonYield/energy, r.ElectronYield/energy, r.ExcitonRatio, r.Lindhard, r.DeltaT_Scint};
+        table.valid[i] = true;
+        for (double v : n)
+            if (!std::isfinite(v)) table.valid[i] = false;
+    }
+    return table;
+}
+
+G4bool NESTYieldCache::Lookup(NEST::INTERACTION_TYPE species, double energy, double density, double dfield,
+                              double A, double Z, const std::vector<double>& NuisParam,
+                              const std::vector<double>& ERYieldsParam, bool oldModelER,
+                              NEST::YieldResult& result) {
+    if (species == NEST::Kr83m || species == NEST::NoneType) return false;
+    if (!(energy > 0.) || !(density > 0.)) return false;
+
+    const double le = std::log10(energy);
+    if (le < kLogEMin || le >= kLogEMax) return false;
+
+    const double fe = (le - kLogEMin)*kPerDecade;
+    const int ie = int(fe);
+    const double te = fe - ie;
+
+    const double fu = std::log(1. + std::max(dfield, 0.))/kFieldStep;
+    const int iu = int(std::floor(fu));
+    const double tu = fu - iu;
+
+    const double fw = std::log(density)/kDensityStep;
+    const int iw = int(std::floor(fw));
+    const double tw = fw - iw;
+
+    Node value {0., 0., 0., 0., 0.};
+    for (int a = 0; a < 2; a++){
+        for (int b = 0; b < 2; b++){
+            const double w = (a ? tu : 1. - tu)*(b ? tw : 1. - tw);
+            const Table& t = GetTable(species, A, Z, NuisParam, ERYieldsParam, oldModelER, iu + a, iw + b);
+            if (!t.valid[ie] || !t.valid[ie + 1]) return false;
+            for (std::size_t k = 0; k < value.size(); k++)
+                value[k] += w*((1. - te)*t.nodes[ie][k] + te*t.nodes[ie + 1][k]);
+        }
+    }
+
+    result.PhotonYield = value[0]*energy;
+    result.ElectronYield = value[1]*energy;
+    result.ExcitonRatio = value[2];
+    result.Lindhard = value[3];
+    result.ElectricField = dfield;
+    result.DeltaT_Scint = value[4];
+    return true;
+}
+
+NEST::YieldResult NESTYieldCache::GetYields(NEST::INTERACTION_TYPE species, double energy, double density, double dfield,
+                                            double A, double Z, const std::vector<double>& NuisParam,
+                                            const std::vector<double>& ERYieldsParam, bool oldModelER) {
+    NEST::YieldResult cached;
+    auto start = std::chrono::steady_clock::now();
+    if (!Lookup(species, energy, density, dfield, A, Z, NuisParam, ERYieldsParam, oldModelER, cached)){
+        fDirect++;
+        return NEST::NESTcalc::GetYields(species, energy, density, dfield, A, Z, NuisParam, ERYieldsParam, oldModelER);
+    }
+    fHits++;
+
+    if (fCompareInterval > 0 && fHits % fCompareInterval == 0){
+        auto middle = std::chrono::steady_clock::now();
+        NEST::YieldResult direct = NEST::NESTcalc::GetYields(species, energy, density, dfield, A, Z, NuisParam, ERYieldsParam, oldModelER);
+        auto end = std::chrono::steady_clock::now();
+        fCachedTime += std::chrono::duration<double>(middle - start).count();
+        fDirectTime += std::chrono::duration<double>(end - middle).count();
+
+        double dPhotons = std::abs(cached.PhotonYield - direct.PhotonYield)/std::max(std::abs(direct.PhotonYield), 1.);
+        double dElectrons = std::abs(cached.ElectronYield - direct.ElectronYield)/std::max(std::abs(direct.ElectronYield), 1.);
+        fCompared++;
+        fPhotonDiffSum += dPhotons;
+        fElectronDiffSum += dElectrons;
+        fPhotonDiffMax = std::max(fPhotonDiffMax, dPhotons);
+        fElectronDiffMax = std::max(fElectronDiffMax, dElectrons);
+    }
+
+    return cached;
+}
+
+void NESTYieldCache::PrintStatistics() {
+    NESTYieldCache* c = fInstance;
+    if (!c) return;
+    // The master of an MT run builds the physics but never tracks
+    if (c->fHits + c->fDirect == 0 && G4Threading::IsMultithreadedApplication() && G4Threading::IsMasterThread()) return;
+
+    G4cout << "NESTYieldCache: " << c->fHits << " yields from " << c->fTables.size() << " tables, "
+           << c->fDirect << " from NEST" << G4endl;
+    if (c->fCompared > 0){
+        G4cout << "  " << c->fCompared << " compared with NEST: photons mean/max relative difference "
+               << c->fPhotonDiffSum/c->fCompared << "/" << c->fPhotonDiffMax
+               << ", electrons " << c->fElectronDiffSum/c->fCompared << "/" << c->fElectronDiffMax << G4endl;
+        if (c->fCachedTime > 0.)
+            G4cout << "  time per request [us]: cache " << 1e6*c->fCachedTime/c->fCompared
+                   << ", NEST " << 1e6*c->fDirectTime/c->fCompared << G4endl;
+    }
+
+    c->fHits = 0;
+    c->fDirect = 0;
+    c->fCompared = 0;
+    c->fPhotonDiffSum = c->fElectronDiffSum = 0.;
+    c->fPhotonDiffMax = c->fElectronDiffMax = 0.;
+    c->fCachedTime = c->fDirectTime = 0.;
+}
@@ -0,0 +1,86 @@
+/*
+ * NESTYieldCache.hh
+ *
+ * NESTcalc whose mean yields come from tables. GetYields is evaluated by NEST
+ * on a grid of log energy for each interaction type, A, Z and nuisance
+ * parameters, at nodes in field and density; later requests are interpolated
+ * between the nodes around them. A node table is built the first time a
+ * request falls next to it, so a run at fixed field and density builds four.
+ * The quanta are still drawn by NESTcalc::GetQuanta from the yields, so the
+ * fluctuations are those of NEST. Kr83m, and energies outside the grid, go to
+ * NEST directly.
+ *
+ * One request in SetCompareInterval() is also sent to NEST and the yields are
+ * compared, PrintStatistics() reports the differences and timings of the
+ * thread at the end of the run. The report is printed whenever the cache was
+ * built, so a run whose NEST requests never reach it shows 0 yields.
+ *
+ * GetYields overrides the virtual NESTcalc::GetYields of NEST 2.3.x, with
+ * the ER yield parameters; the defaults come from the NESTcalc declaration.
+ */
+
+#ifndef NESTYieldCache_h
+#define NESTYieldCache_h 1
+
+#include "globals.hh"
+#include "NEST.hh"
+
+#include <array>
+#include <map>
+#include <tuple>
+#include <vector>
+
+class NESTYieldCache : public NEST::NESTcalc
+{
+public:
+    explicit NESTYieldCache(VDetector* detector);
+    ~NESTYieldCache();
+
+    NEST::YieldResult GetYields(NEST::INTERACTION_TYPE species, double energy, double density, double dfield,
+                                double A, double Z, const std::vector<double>& NuisParam,
+                                const std::vector<double>& ERYieldsParam, bool oldModelER) override;
+
+    // Used by the physics list when it builds NEST, true by default
+    static void SetEnabled(G4bool b){fEnabled = b;};
+    static G4bool IsEnabled(){return fEnabled;};
+    // Compare one request in n with NEST, 0 never
+    static void SetCompareInterval(G4int n){fCompareInterval = n;};
+
+    // Hits, direct calls and the comparison of the cache of this thread
+    static void PrintStatistics();
+
+private:
+    // Per energy node: photons/keV, electrons/keV, exciton ratio, Lindhard, scintillation delay
+    typedef std::array<double, 5> Node;
+    struct Table {
+        std::vector<Node> nodes;
+        std::vector<bool> valid;
+    };
+    // Species, A, Z, nuisance and ER yield parameters, old ER model, field node, density node
+    typedef std::tuple<int, double, double, std::vector<double>, std::vector<double>, bool, int, int> Key;
+
+    const Table& GetTable(NEST::INTERACTION_TYPE species, double A, double Z, const std::vector<double>& NuisParam,
+                          const std::vector<double>& ERYieldsParam, bool oldModelER, int fieldNode, int densityNode);
+    // Interpolated yields, false outside the grid or next to a node NEST could not fill
+    G4bool Lookup(NEST::INTERACTION_TYPE species, double energy, double density, double dfield, double A, double Z,
+                  const std::vector<double>& NuisParam, const std::vector<double>& ERYieldsParam, bool oldModelER,
+                  NEST::YieldResult& result);
+
+    std::map<Key, Table> fTables;
+
+    G4long fHits;
+    G4long fDirect;
+    G4long fCompared;
+    G4double fPhotonDiffSum;
+    G4double fElectronDiffSum;
+    G4double fPhotonDiffMax;
+    G4double fElectronDiffMax;
+    G4double fCachedTime;   // s, in the compared requests
+    G4double fDirectTime;   // s, in the compared requests
+
+    static G4bool fEnabled;
+    static G4int fCompareInterval;
+    static G4ThreadLocal NESTYieldCache* fInstance;
+};
+
+#endif
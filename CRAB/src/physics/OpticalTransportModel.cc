@@ -0,0 +1,449 @@
+#include "OpticalTransportModel.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Track.hh"
+#include "G4NavigationHistory.hh"
+#include "G4AffineTransform.hh"
+#include "G4Step.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4LogicalBorderSurface.hh"
+#include "G4OpticalSurface.hh"
+#include "G4Material.hh"
+#include "G4Tubs.hh"
+#include "G4Box.hh"
+#include "G4ExtrudedSolid.hh"
+#include "Randomize.hh"
+
+#include "DetectorConstruction.hh"
+#include "S2Photon.hh"
+
+// Surfaces closer than this are ignored so a photon does not re-hit the surface it left
+const static G4double kSurfaceTolerance = 1.e-6 * mm;
+
+OpticalTransportModel::OpticalTransportModel(GasModelParameters* gmp, G4String modelName, G4Region* envelope, DetectorConstruction* dc)
+    : G4VFastSimulationModel(modelName, envelope), fGasModelParameters(gmp), detCon(dc), fGasPhys(nullptr),
+      fBarrelReflectivity(nullptr), fRindex(nullptr), fAbsLength(nullptr), fMaxBounces(100) {
+
+    G4LogicalVolume* gasLogic = detCon->GetGasLogical();
+    for (auto pv : *G4PhysicalVolumeStore::GetInstance()){
+        if (pv->GetLogicalVolume() == gasLogic){
+            fGasPhys = pv;
+            break;
+        }
+    }
+
+    if (!fGasPhys)
+        G4Exception("[OpticalTransportModel]", "OpticalTransportModel()", FatalException,
+                    "Could not find the placement of the gas volume");
+
+    BuildDescription(fGasPhys);
+}
+
+G4bool OpticalTransportModel::IsApplicable(const G4ParticleDefinition& particleType) {
+    if (&particleType == S2Photon::OpticalPhoton() || &particleType == G4OpticalPhoton::OpticalPhoton())
+        return true;
+    return false;
+}
+
+G4bool OpticalTransportModel::ModelTrigger(const G4FastTrack& fastTrack) {
+    if (!fGasModelParameters->GetbFastOptics())
+        return false;
+
+    const G4Track* track = fastTrack.GetPrimaryTrack();
+
+    // Only in the gas itself, never inside one of its daughters
+    if (track->GetVolume() != fGasPhys)
+        return false;
+
+    // The photon was just handed back by this model, let Geant4 take the next step
+    const G4Step* step = track->GetStep();
+    if (step && track->GetCurrentStepNumber() > 0 &&
+        step->GetPreStepPoint()->GetStepStatus() == fExclusivelyForcedProc)
+        return false;
+
+    return true;
+}
+
+void OpticalTransportModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) {
+    const G4Track* track = fastTrack.GetPrimaryTrack();
+
+    // The surfaces are described in the frame of the gas volume, which the
+    // touchable of the track gives wherever the gas is placed
+    const G4AffineTransform& toGas = track->GetTouchableHandle()->GetHistory()->GetTopTransform();
+    const G4AffineTransform toGlobal = toGas.Inverse();
+    G4ThreeVector pos = toGas.TransformPoint(track->GetPosition());
+    G4ThreeVector dir = toGas.TransformAxis(track->GetMomentumDirection());
+    G4ThreeVector pol = toGas.TransformAxis(track->GetPolarization());
+    G4double time = track->GetGlobalTime();
+    G4double energy = track->GetKineticEnergy();
+
+    G4double rindex = fRindex ? fRindex->Value(energy) : 1.0;
+    G4double absLength = fAbsLength ? fAbsLength->Value(energy) : DBL_MAX;
+    G4double pathToAbsorption = (absLength < DBL_MAX) ? -absLength*std::log(G4UniformRand()) : DBL_MAX;
+    G4double travelled = 0.;
+
+    counter[0]++;
+    if (!(counter[0]%100000))
+        G4cout << "OpticalTransportModel: photons " << counter[0] << ", bounces " << counter[1]
+               << ", handed back " << counter[2] << G4endl;
+
+    for (G4int bounce = 0; bounce < fMaxBounces; bounce++){
+
+        // Nearest surface along the ray
+        G4ThreeVector normal, hitNormal;
+        G4bool barrel(false);
+        G4double dist = DistanceToGasBoundary(pos, dir, hitNormal, barrel);
+        const AnalyticSolid* hit = nullptr;
+
+        for (const auto& solid : fSolids){
+            G4double d = solid.isTube ? DistanceToTube(solid, pos, dir, normal) : DistanceToBox(solid, pos, dir, normal);
+            if (d < dist){
+                dist = d;
+                hit = &solid;
+                hitNormal = normal;
+            }
+        }
+
+        // Should not happen in a closed volume, leave it to Geant4
+        if (dist == DBL_MAX)
+            break;
+
+        if (travelled + dist > pathToAbsorption){
+            fastStep.KillPrimaryTrack();
+            return;
+        }
+
+        travelled += dist;
+        pos += dist*dir;
+        time += dist*rindex/c_light;
+
+        SurfaceKind kind;
+        G4MaterialPropertyVector* reflectivity = nullptr;
+        if (hit){
+            kind = hit->kind;
+            reflectivity = hit->reflectivity;
+        }
+        else {
+            kind = barrel ? (fBarrelReflectivity ? kReflect : kAbsorb) : kExit;
+            reflectivity = fBarrelReflectivity;
+        }
+
+        if (kind == kMesh){
+            G4ThreeVector local = pos - hit->centre;
+            if (std::abs(dir.z()) > 0. && local.perp() < hit->holeRadius && G4UniformRand() < hit->transmission){
+                // Through one of the holes, carry on past the mesh
+                G4double across = 2.*hit->halfz/std::abs(dir.z()) + kSurfaceTolerance;
+                travelled += across;
+                pos += across*dir;
+                time += across*rindex/c_light;
+                continue;
+            }
+            kind = reflectivity ? kReflect : kAbsorb;
+        }
+
+        if (kind == kExit){
+            // Hand back just in front of the dielectric, G4OpBoundary takes it from there
+            counter[2]++;
+            pos -= kSurfaceTolerance*dir;
+            fastStep.ProposePrimaryTrackFinalPosition(toGlobal.TransformPoint(pos), false);
+            fastStep.ProposePrimaryTrackFinalTime(time);
+            fastStep.ProposePrimaryTrackFinalMomentumDirection(toGlobal.TransformAxis(dir), false);
+            fastStep.ProposePrimaryTrackFinalPolarization(toGlobal.TransformAxis(pol), false);
+            fastStep.ProposePrimaryTrackPathLength(travelled);
+            return;
+        }
+
+        if (kind == kAbsorb || G4UniformRand() > reflectivity->Value(energy)){
+            fastStep.KillPrimaryTrack();
+            return;
+        }
+
+        // Specular reflection, polished steel
+        counter[1]++;
+        dir = (dir - 2.*dir.dot(hitNormal)*hitNormal).unit();
+        pol = pol - 2.*pol.dot(hitNormal)*hitNormal;
+        pol = (pol - pol.dot(dir)*dir);
+        pol = (pol.mag2() > 0.) ? pol.unit() : dir.orthogonal().unit();
+    }
+
+    // Ran out of bounces or lost the photon, give it back to Geant4 where it is
+    fastStep.ProposePrimaryTrackFinalPosition(toGlobal.TransformPoint(pos), false);
+    fastStep.ProposePrimaryTrackFinalTime(time);
+    fastStep.ProposePrimaryTrackFinalMomentumDirection(toGlobal.TransformAxis(dir), false);
+    fastStep.ProposePrimaryTrackFinalPolarization(toGlobal.TransformAxis(pol), false);
+    fastStep.ProposePrimaryTrackPathLength(travelled);
+}
+
+void OpticalTransportModel::BuildDescription(G4VPhysicalVolume* gasPhys) {
+    G4LogicalVolume* gasLogic = gasPhys->GetLogicalVolume();
+    G4Material* gas = gasLogic->GetMaterial();
+
+    G4Tubs* gasSolid = dynamic_cast<G4Tubs*>(gasLogic->GetSolid());
+    if (!gasSolid)
+        G4Exception("[OpticalTransportModel]", "BuildDescription()", FatalException,
+                    "The gas volume must be a G4Tubs");
+
+    fGasR = gasSolid->GetOuterRadius();
+    fGasHalfZ = gasSolid->GetZHalfLength();
+
+    if (gas->GetMaterialPropertiesTable()){
+        fRindex = gas->GetMaterialPropertiesTable()->GetProperty("RINDEX");
+        fAbsLength = gas->GetMaterialPropertiesTable()->GetProperty("ABSLENGTH");
+    }
+
+    // The barrel reflectivity comes from the surface between the gas and the chamber outside it
+    for (const auto& entry : *G4LogicalBorderSurface::GetSurfaceTable()){
+        G4LogicalBorderSurface* surface = entry.second;
+        if (surface->GetVolume1() == gasPhys && surface->GetVolume2()->GetMotherLogical() != gasLogic){
+            fBarrelReflectivity = BorderReflectivity(gasPhys, const_cast<G4VPhysicalVolume*>(surface->GetVolume2()));
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < gasLogic->GetNoDaughters(); i++){
+        G4VPhysicalVolume* daughter = gasLogic->GetDaughter(i);
+        G4LogicalVolume* logic = daughter->GetLogicalVolume();
+        G4Material* mat = logic->GetMaterial();
+
+        // More gas, transparent
+        if (mat == gas) continue;
+
+        AnalyticSolid solid;
+        solid.reflectivity = nullptr;
+        solid.holeRadius = 0.;
+        solid.transmission = 0.;
+
+        // Dielectrics are left to Geant4, reflective metals need a border surface, the rest absorbs
+        G4MaterialPropertiesTable* mpt = mat->GetMaterialPropertiesTable();
+        if (mpt && mpt->GetProperty("RINDEX"))
+            solid.kind = kExit;
+        else {
+            solid.reflectivity = BorderReflectivity(gasPhys, daughter);
+            solid.kind = solid.reflectivity ? kReflect : kAbsorb;
+        }
+
+        G4RotationMatrix rot = daughter->GetObjectRotationValue();
+        G4ThreeVector trans = daughter->GetObjectTranslation();
+        G4Tubs* tubs = dynamic_cast<G4Tubs*>(logic->GetSolid());
+
+        // A box stays exact when its axes are mapped onto the axes of the gas
+        G4bool alignedAxes = true;
+        for (G4int k = 0; k < 3; k++){
+            G4ThreeVector axis = rot*G4ThreeVector(k == 0, k == 1, k == 2);
+            if (std::max(std::abs(axis.x()), std::max(std::abs(axis.y()), std::abs(axis.z()))) < 1. - 1.e-9)
+                alignedAxes = false;
+        }
+
+        // Tubes whose axis stays along z are kept exactly, everything else becomes its bounding box
+        solid.exact = true;
+        if (tubs && std::abs((rot*G4ThreeVector(0.,0.,1.)).z()) > 1. - 1.e-9 && tubs->GetDeltaPhiAngle() >= twopi){
+            solid.isTube = true;
+            solid.centre = trans;
+            solid.rmin = tubs->GetInnerRadius();
+            solid.rmax = tubs->GetOuterRadius();
+            solid.halfz = tubs->GetZHalfLength();
+        }
+        else {
+            G4ThreeVector bmin, bmax;
+            logic->GetSolid()->BoundingLimits(bmin, bmax);
+            solid.isTube = false;
+            solid.exact = dynamic_cast<G4Box*>(logic->GetSolid()) && alignedAxes;
+            // The real surface lies somewhere inside, Geant4 has to find it
+            if (!solid.exact)
+                solid.kind = kExit;
+            solid.pmin = G4ThreeVector( DBL_MAX,  DBL_MAX,  DBL_MAX);
+            solid.pmax = G4ThreeVector(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+            for (G4int c = 0; c < 8; c++){
+                G4ThreeVector corner((c & 1) ? bmax.x() : bmin.x(), (c & 2) ? bmax.y() : bmin.y(), (c & 4) ? bmax.z() : bmin.z());
+                corner = rot*corner + trans;
+                solid.pmin.set(std::min(solid.pmin.x(), corner.x()), std::min(solid.pmin.y(), corner.y()), std::min(solid.pmin.z(), corner.z()));
+                solid.pmax.set(std::max(solid.pmax.x(), corner.x()), std::max(solid.pmax.y(), corner.y()), std::max(solid.pmax.z(), corner.z()));
+            }
+        }
+
+        // Meshes: a metal disk with gas holes as daughters
+        if (solid.isTube && solid.kind != kExit && logic->GetNoDaughters() > 0){
+            G4double holeArea(0.);
+            for (size_t j = 0; j < logic->GetNoDaughters(); j++){
+                G4VPhysicalVolume* hole = logic->GetDaughter(j);
+                if (hole->GetLogicalVolume()->GetMaterial() != gas) continue;
+
+                G4VSolid* holeSolid = hole->GetLogicalVolume()->GetSolid();
+                G4ThreeVector hmin, hmax;
+                holeSolid->BoundingLimits(hmin, hmax);
+
+                G4ExtrudedSolid* extruded = dynamic_cast<G4ExtrudedSolid*>(holeSolid);
+                if (extruded){
+                    std::vector<G4TwoVector> polygon = extruded->GetPolygon();
+                    G4double area(0.);
+                    for (size_t k = 0; k < polygon.size(); k++){
+                        const G4TwoVector& a = polygon[k];
+                        const G4TwoVector& b = polygon[(k+1)%polygon.size()];
+                        area += a.x()*b.y() - b.x()*a.y();
+                    }
+                    holeArea += std::abs(area)/2.;
+                }
+                else
+                    holeArea += holeSolid->GetCubicVolume()/(hmax.z() - hmin.z());
+
+                G4double extent = std::max(std::max(std::abs(hmin.x()), std::abs(hmax.x())), std::max(std::abs(hmin.y()), std::abs(hmax.y())));
+                solid.holeRadius = std::max(solid.holeRadius, hole->GetObjectTranslation().perp() + extent);
+            }
+
+            if (holeArea > 0.){
+                solid.kind = kMesh;
+                solid.holeRadius = std::min(solid.holeRadius, solid.rmax);
+                solid.transmission = std::min(1., holeArea/(pi*solid.holeRadius*solid.holeRadius));
+            }
+        }
+
+        fSolids.push_back(solid);
+    }
+
+    G4cout << "OpticalTransportModel: gas R = " << fGasR/cm << " cm, half length = " << fGasHalfZ/cm
+           << " cm, " << fSolids.size() << " analytic solids" << G4endl;
+}
+
+G4MaterialPropertyVector* OpticalTransportModel::BorderReflectivity(G4VPhysicalVolume* from, G4VPhysicalVolume* to) {
+    G4LogicalBorderSurface* border = G4LogicalBorderSurface::GetSurface(from, to);
+    if (!border) return nullptr;
+
+    G4OpticalSurface* surface = dynamic_cast<G4OpticalSurface*>(border->GetSurfaceProperty());
+    if (!surface || surface->GetType() != dielectric_metal || !surface->GetMaterialPropertiesTable())
+        return nullptr;
+
+    return surface->GetMaterialPropertiesTable()->GetProperty("REFLECTIVITY");
+}
+
+G4double OpticalTransportModel::DistanceToTube(const AnalyticSolid& s, const G4ThreeVector& pos, const G4ThreeVector& dir, G4ThreeVector& normal) {
+    G4ThreeVector q = pos - s.centre;
+    G4double best = DBL_MAX;
+
+    // End faces, only when approaching them from outside
+    if (dir.z() != 0.){
+        for (G4int side = -1; side <= 1; side += 2){
+            if (side*dir.z() >= 0.) continue;
+            G4double t = (side*s.halfz - q.z())/dir.z();
+            if (t <= kSurfaceTolerance || t >= best) continue;
+            G4double r2 = (q + t*dir).perp2();
+            if (r2 >= s.rmin*s.rmin && r2 <= s.rmax*s.rmax){
+                best = t;
+                normal = G4ThreeVector(0., 0., side);
+            }
+        }
+    }
+
+    G4double a = dir.x()*dir.x() + dir.y()*dir.y();
+    if (a <= 0.) return best;
+    G4double b = q.x()*dir.x() + q.y()*dir.y();
+    G4double r2 = q.perp2();
+
+    // Outer cylinder from outside: smaller root
+    G4double c = r2 - s.rmax*s.rmax;
+    G4double disc = b*b - a*c;
+    if (c > 0. && disc >= 0.){
+        G4double t = (-b - std::sqrt(disc))/a;
+        if (t > kSurfaceTolerance && t < best && std::abs(q.z() + t*dir.z()) <= s.halfz){
+            best = t;
+            G4ThreeVector p = q + t*dir;
+            normal = G4ThreeVector(p.x(), p.y(), 0.).unit();
+        }
+    }
+
+    // Inner cylinder from inside the bore: larger root
+    if (s.rmin > 0.){
+        c = r2 - s.rmin*s.rmin;
+        disc = b*b - a*c;
+        if (disc >= 0.){
+            G4double t = (-b + std::sqrt(disc))/a;
+            if (t > kSurfaceTolerance && t < best && std::abs(q.z() + t*dir.z()) <= s.halfz){
+                best = t;
+                G4ThreeVector p = q + t*dir;
+                normal = -G4ThreeVector(p.x(), p.y(), 0.).unit();
+            }
+        }
+    }
+
+    return best;
+}
+
+G4double OpticalTransportModel::DistanceToBox(const AnalyticSolid& s, const G4ThreeVector& pos, const G4ThreeVector& dir, G4ThreeVector& normal) {
+    // Slab method, entering distance is the largest of the near planes and
+    // leaving distance the smallest of the far planes
+    G4double tNear = -DBL_MAX, tFar = DBL_MAX;
+    G4int axis = -1, farAxis = -1;
+    G4double sign = 0., farSign = 0.;
+
+    for (G4int i = 0; i < 3; i++){
+        if (dir[i] == 0.){
+            if (pos[i] < s.pmin[i] || pos[i] > s.pmax[i]) return DBL_MAX;
+            continue;
+        }
+        G4double t1 = (s.pmin[i] - pos[i])/dir[i];
+        G4double t2 = (s.pmax[i] - pos[i])/dir[i];
+        G4double faceSign = -1.;
+        if (t1 > t2){
+            std::swap(t1, t2);
+            faceSign = 1.;
+        }
+        if (t1 > tNear){
+            tNear = t1;
+            axis = i;
+            sign = faceSign;
+        }
+        if (t2 < tFar){
+            tFar = t2;
+            farAxis = i;
+            farSign = -faceSign;
+        }
+    }
+
+    if (axis < 0 || tNear > tFar || tFar <= kSurfaceTolerance) return DBL_MAX;
+
+    // Starting inside: at once for a bounding box, so that Geant4 locates the
+    // photon, otherwise at the face it leaves through
+    if (tNear <= kSurfaceTolerance){
+        normal = G4ThreeVector();
+        normal[farAxis] = farSign;
+        return s.exact ? tFar : 0.;
+    }
+
+    normal = G4ThreeVector();
+    normal[axis] = sign;
+    return tNear;
+}
+
+G4double OpticalTransportModel::DistanceToGasBoundary(const G4ThreeVector& pos, const G4ThreeVector& dir, G4ThreeVector& normal, G4bool& barrel) {
+    G4double best = DBL_MAX;
+
+    if (dir.z() != 0.){
+        G4double t = ((dir.z() > 0. ? fGasHalfZ : -fGasHalfZ) - pos.z())/dir.z();
+        if (t > kSurfaceTolerance){
+            best = t;
+            normal = G4ThreeVector(0., 0., dir.z() > 0. ? -1. : 1.);
+            barrel = false;
+        }
+    }
+
+    G4double a = dir.x()*dir.x() + dir.y()*dir.y();
+    if (a > 0.){
+        G4double b = pos.x()*dir.x() + pos.y()*dir.y();
+        G4double c = pos.perp2() - fGasR*fGasR;
+        G4double disc = b*b - a*c;
+        if (disc >= 0.){
+            G4double t = (-b + std::sqrt(disc))/a;
+            if (t > kSurfaceTolerance && t < best){
+                best = t;
+                G4ThreeVector p = pos + t*dir;
+                normal = -G4ThreeVector(p.x(), p.y(), 0.).unit();
+                barrel = true;
+            }
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,79 @@
+/*
+ * OpticalTransportModel.hh
+ *
+ * Fast straight-line transport of optical/S2 photons through the gas.
+ * The daughters of the gas volume are reduced to analytic tubes and boxes
+ * when the model is built, photons are then moved from surface to surface
+ * without the navigator. Solids that are not a tube along z or an axis
+ * aligned box are only known by their bounding box, photons reaching one are
+ * handed back to Geant4. Steel is reflected specularly with the reflectivity
+ * of its border surface, meshes are crossed with their open-area fraction and
+ * all other materials absorb. The photon is handed back to Geant4 in front of
+ * any dielectric (lens, windows) so refraction there is left to G4OpBoundary.
+ */
+
+#ifndef OpticalTransportModel_h
+#define OpticalTransportModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "G4MaterialPropertyVector.hh"
+#include "G4ThreeVector.hh"
+#include "GasModelParameters.hh"
+
+#include <vector>
+
+class G4VPhysicalVolume;
+class DetectorConstruction;
+
+class OpticalTransportModel : public G4VFastSimulationModel
+{
+public:
+    OpticalTransportModel(GasModelParameters*, G4String, G4Region*, DetectorConstruction*);
+    ~OpticalTransportModel(){};
+
+    virtual G4bool IsApplicable(const G4ParticleDefinition&);
+    virtual G4bool ModelTrigger(const G4FastTrack&);
+    virtual void DoIt(const G4FastTrack&, G4FastStep&);
+
+private:
+    // What happens to a photon arriving at a surface
+    enum SurfaceKind { kReflect, kAbsorb, kExit, kMesh };
+
+    // Daughter of the gas reduced to a tube along z or an axis aligned box
+    struct AnalyticSolid {
+        G4bool isTube;
+        G4bool exact;                   // false for the bounding box of another solid
+        G4ThreeVector centre;
+        G4double rmin, rmax, halfz;     // tube
+        G4ThreeVector pmin, pmax;       // box
+        SurfaceKind kind;
+        G4MaterialPropertyVector* reflectivity;
+        G4double holeRadius;            // mesh: radius covered by holes
+        G4double transmission;          // mesh: open-area fraction inside holeRadius
+    };
+
+    void BuildDescription(G4VPhysicalVolume* gasPhys);
+    G4MaterialPropertyVector* BorderReflectivity(G4VPhysicalVolume* from, G4VPhysicalVolume* to);
+
+    // Distance along dir to the surface of the solid, outward normal at the hit
+    G4double DistanceToTube(const AnalyticSolid&, const G4ThreeVector& pos, const G4ThreeVector& dir, G4ThreeVector& normal);
+    G4double DistanceToBox(const AnalyticSolid&, const G4ThreeVector& pos, const G4ThreeVector& dir, G4ThreeVector& normal);
+    // Distance to the boundary of the gas from inside, true if it is the barrel
+    G4double DistanceToGasBoundary(const G4ThreeVector& pos, const G4ThreeVector& dir, G4ThreeVector& normal, G4bool& barrel);
+
+    GasModelParameters* fGasModelParameters;
+    DetectorConstruction* detCon;
+    G4VPhysicalVolume* fGasPhys;
+
+    std::vector<AnalyticSolid> fSolids;
+    G4double fGasR;
+    G4double fGasHalfZ;
+    G4MaterialPropertyVector* fBarrelReflectivity;
+    G4MaterialPropertyVector* fRindex;
+    G4MaterialPropertyVector* fAbsLength;
+
+    G4int fMaxBounces;
+    std::vector<G4long> counter {0,0,0}; // photons, bounces, handed back
+};
+
+#endif
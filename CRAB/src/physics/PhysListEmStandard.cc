@@ -73,6 +73,7 @@
 
 #include "gasNESTdet.hh"
 #include "G4/NESTProc.hh"
+#include "NESTYieldCache.hh"
 #include "G4OpRayleigh.hh"
 #include "OpAbsorption.hh"
 #include "OpWLS.hh"
@@ -211,7 +212,8 @@ void PhysListEmStandard::ConstructProcess() {
 
   gasNESTdet* gndet = new gasNESTdet();
   // std::shared_ptr<gasNESTdet> gndet(new gasNESTdet());
-  NEST::NESTcalc* calcNEST = new NEST::NESTcalc(gndet);  
+  NEST::NESTcalc* calcNEST = NESTYieldCache::IsEnabled() ? new NESTYieldCache(gndet) : new NEST::NESTcalc(gndet);
+  G4cout << "PhysListEmStandard: NEST yields " << (NESTYieldCache::IsEnabled() ? "through NESTYieldCache" : "from NESTcalc") << G4endl;
 
   NEST::NESTProc* theNEST2ScintillationProcess = new NEST::NESTProc("S1",fElectromagnetic, calcNEST, gndet); //gndet);
   theNEST2ScintillationProcess->SetDetailedSecondaries(true);
@@ -67,6 +67,13 @@
 #include "G4FastSimulationPhysics.hh"
 #include "G4GlobalFastSimulationManager.hh"
 
+#include "G4Material.hh"
+#include "G4Version.hh"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
 
 #ifdef theParticleIterator
 #undef theParticleIterator
@@ -75,7 +82,9 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 PhysicsList::PhysicsList()
-    : G4VModularPhysicsList(), lowE(-1){
+    : G4VModularPhysicsList(), lowE(-1), cutForGasRegion(1. * um), emName("emlivermore"),
+      cacheDir(""), tablesRetrieved(false), tablesStored(false){
+  startTime = std::chrono::steady_clock::now();
   G4LossTableManager::Instance();
   defaultCutValue = 10. * um;
   cutForGamma = defaultCutValue;
@@ -129,6 +138,7 @@ void PhysicsList::InitializePhysicsList(const G4String& name) {
   if (verboseLevel > 1) {
     G4cout << "PhysicsList::AddPhysicsList: <" << name << ">" << G4endl;
   }
+  emName = name;
 
   if (name == "local") {
     ReplacePhysics(new PhysListEmStandard(name));
@@ -172,14 +182,38 @@ void PhysicsList::SetCuts() {
   
   G4Region* region = G4RegionStore::GetInstance()->GetRegion("GasRegion");
   G4ProductionCuts* cuts = new G4ProductionCuts();
-  cuts->SetProductionCut(1 * um, G4ProductionCuts::GetIndex("gamma"));
-  cuts->SetProductionCut(1 * um, G4ProductionCuts::GetIndex("e-"));
-  cuts->SetProductionCut(1 * um, G4ProductionCuts::GetIndex("e+"));
+  cuts->SetProductionCut(cutForGasRegion, G4ProductionCuts::GetIndex("gamma"));
+  cuts->SetProductionCut(cutForGasRegion, G4ProductionCuts::GetIndex("e-"));
+  cuts->SetProductionCut(cutForGasRegion, G4ProductionCuts::GetIndex("e+"));
   
   if (region) {
     region->SetProductionCuts(cuts);
   }
 
+  // Retrieve the tables if a cache for exactly this configuration exists
+  if (cacheDir != "") {
+    cacheKey = PhysicsTableKey();
+    std::stringstream hash;
+    hash << std::hex << std::hash<std::string>{}(cacheKey);
+    cachePath = cacheDir + "/" + hash.str();
+
+    std::ifstream config(cachePath + "/config.txt");
+    std::string storedKey;
+    std::getline(config, storedKey);
+
+    if (config.good() && storedKey == cacheKey) {
+      G4cout << "PhysicsList: retrieving physics tables from " << cachePath << G4endl;
+      SetPhysicsTableRetrieved(cachePath);
+      tablesRetrieved = true;
+    }
+    else {
+      if (config.good())
+        G4cout << "PhysicsList: cached tables in " << cachePath << " do not match the current configuration, rebuilding" << G4endl;
+      ResetPhysicsTableRetrieved();
+      tablesRetrieved = false;
+    }
+  }
+
   G4cout << "The lower energy production cut after call to GetProductionCutsTable()->SetEnergyRange(lowE, 100. * MeV) is now set to: " << lowE << G4endl;
   if (verboseLevel > 0) DumpCutValuesTable();
 }
@@ -229,6 +263,54 @@ void PhysicsList::AddIonGasModels() {
   }
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Everything the tables depend on: EM constructor, cuts, energy range,
+// materials in use and the Geant4 version
+G4String PhysicsList::PhysicsTableKey() {
+  std::stringstream key;
+  key << G4Version << ";em=" << emName
+      << ";gcut=" << cutForGamma/um << ";ecut=" << cutForElectron/um << ";pcut=" << cutForPositron/um
+      << ";gasregioncut=" << cutForGasRegion/um << ";lowE=" << lowE/eV;
+
+  for (auto mat : *G4Material::GetMaterialTable())
+    key << ";" << mat->GetName() << "=" << mat->GetDensity()/(g/cm3);
+
+  return key.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsList::UpdatePhysicsTableCache() {
+  if (cacheDir == "" || tablesStored) return;
+  tablesStored = true;
+
+  G4double startup = std::chrono::duration<G4double>(std::chrono::steady_clock::now() - startTime).count();
+
+  if (tablesRetrieved) {
+    // Report against the cold start recorded when the tables were stored
+    std::ifstream config(cachePath + "/config.txt");
+    std::string storedKey;
+    G4double coldStartup(0.);
+    std::getline(config, storedKey);
+    config >> coldStartup;
+    G4cout << "PhysicsList: warm start-up took " << startup << " s, cold start-up took " << coldStartup << " s" << G4endl;
+    return;
+  }
+
+  std::filesystem::create_directories(cachePath.c_str());
+  if (!StorePhysicsTable(cachePath)) {
+    G4Exception("[PhysicsList]", "UpdatePhysicsTableCache()", JustWarning,
+                ("Failed to store the physics tables in " + cachePath).c_str());
+    return;
+  }
+
+  // The key is written last so that a partially stored cache is never used
+  std::ofstream config(cachePath + "/config.txt");
+  config << cacheKey << std::endl << startup << std::endl;
+  G4cout << "PhysicsList: cold start-up took " << startup << " s, tables stored in " << cachePath << G4endl;
+}
+
 //This activates the G4FastSimulationPhysics for all particles and should be called by the user in the macro before '/run/initialize' (command: '/MWGPC/phys/AddParametrisation')
 void PhysicsList::AddParametrisation() {   
     theParticleTable->GetIterator()->reset();
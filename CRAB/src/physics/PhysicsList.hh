@@ -23,6 +23,8 @@
 
 #include "G4/NESTProc.hh"
 
+#include <chrono>
+
 
 class G4VPhysicsConstructor;
 class PhysicsListMessenger;
@@ -45,18 +47,34 @@ class PhysicsList : public G4VModularPhysicsList {
 
   void InitializePhysicsList(const G4String& name);
   void AddParametrisation();
+
+  // Store/retrieve the built physics tables in a cache directory keyed by the
+  // physics configuration, cuts and materials
+  void SetPhysicsTableCache(const G4String& dir){cacheDir=dir;};
+  // Called once the tables are built: stores them on a cold start, reports timing
+  void UpdatePhysicsTableCache();
   
   //   void ConstructParticle();
   //  void ConstructProcess() ; // uncommenting this makes my simulation suddenly have no e- physics, infinite track lengths
   
  private:
   void AddIonGasModels();
+  G4String PhysicsTableKey();
  
 
   G4double cutForGamma;
   G4double cutForElectron;
   G4double cutForPositron;
   G4double lowE;
+  G4double cutForGasRegion;
+
+  G4String emName;
+  G4String cacheDir;
+  G4String cacheKey;
+  G4String cachePath;
+  G4bool tablesRetrieved;
+  G4bool tablesStored;
+  std::chrono::steady_clock::time_point startTime;
 
   PhysicsListMessenger* pMessenger;
   G4FastSimulationPhysics* fastSimulationPhysics;
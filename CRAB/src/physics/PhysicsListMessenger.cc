@@ -1,6 +1,7 @@
 #include "PhysicsListMessenger.hh"
 #include "PhysicsList.hh"
 #include "G4UIcmdWithoutParameter.hh"
+#include "NESTYieldCache.hh"
 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -57,6 +58,23 @@ PhysicsListMessenger::PhysicsListMessenger(PhysicsList* pPhys)
   lowLimitECmd->SetUnitCandidates("eV keV MeV GeV TeV");
 //  lowLimitECmd->SetRange("limit>10.0");
   lowLimitECmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  tableCacheCmd = new G4UIcmdWithAString("/Xenon/phys/setTableCache", this);
+  tableCacheCmd->SetGuidance("Store the physics tables in this directory and retrieve them on later runs");
+  tableCacheCmd->SetGuidance("with the same physics list, cuts and materials.");
+  tableCacheCmd->SetParameterName("dir", false);
+  tableCacheCmd->AvailableForStates(G4State_PreInit);
+
+  nestCacheCmd = new G4UIcmdWithABool("/Xenon/phys/setNESTYieldCache", this);
+  nestCacheCmd->SetGuidance("Interpolate the NEST yields from tables instead of calling NEST for every deposit.");
+  nestCacheCmd->SetParameterName("cache", false);
+  nestCacheCmd->AvailableForStates(G4State_PreInit);
+
+  nestCompareCmd = new G4UIcmdWithAnInteger("/Xenon/phys/setNESTCompareInterval", this);
+  nestCompareCmd->SetGuidance("Compare one cached NEST yield in n with NEST, reported at the end of the run (0 never).");
+  nestCompareCmd->SetParameterName("n", false);
+  nestCompareCmd->SetRange("n>=0");
+  nestCompareCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -70,6 +88,9 @@ PhysicsListMessenger::~PhysicsListMessenger() {
   delete lowLimitECmd;  
   delete physDir;
   delete addParamCmd;
+  delete tableCacheCmd;
+  delete nestCacheCmd;
+  delete nestCompareCmd;
   G4cout << "Deleting PhysicsListMessenger" << G4endl;
 }
 
@@ -106,6 +127,15 @@ void PhysicsListMessenger::SetNewValue(G4UIcommand* command,
   else if(command == addParamCmd){
     pPhysicsList->AddParametrisation();
   }
+  else if(command == tableCacheCmd){
+    pPhysicsList->SetPhysicsTableCache(newValue);
+  }
+  else if(command == nestCacheCmd){
+    NESTYieldCache::SetEnabled(nestCacheCmd->GetNewBoolValue(newValue));
+  }
+  else if(command == nestCompareCmd){
+    NESTYieldCache::SetCompareInterval(nestCompareCmd->GetNewIntValue(newValue));
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
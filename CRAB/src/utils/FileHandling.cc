@@ -5,6 +5,7 @@
 #include <G4SIunits.hh>
 #include "FileHandling.hh"
 #include "G4Exception.hh"
+#include <map>
 namespace filehandler{
     using namespace CLHEP;
     // construct
@@ -247,5 +248,36 @@ namespace filehandler{
 
     }
 
+    void FileHandling::GetEventGroups(string filename, vector<vector<vector<G4double>>> &data) {
+
+        std::ifstream FileIn_(filename);
+        if (!FileIn_.is_open()){
+        G4Exception("[FileHandling]", "GetEventGroups()",
+                    FatalException, " could not read in the CSV file ");
+        }
+
+        std::string s_event, s_x, s_y, s_z, s_e;
+        std::map<G4int, vector<vector<G4double>>> events;
+
+        while (FileIn_.peek()!=EOF) {
+
+            std::getline(FileIn_, s_event, ',');
+            std::getline(FileIn_, s_x, ',');
+            std::getline(FileIn_, s_y, ',');
+            std::getline(FileIn_, s_z, ',');
+            std::getline(FileIn_, s_e, '\n');
+
+            events[stoi(s_event)].push_back({stod(s_x), stod(s_y), stod(s_z), stod(s_e)});
+        }
+
+        FileIn_.close();
+
+        data.clear();
+        for (auto& e : events)
+            data.push_back(std::move(e.second));
+
+        std::cout << "[File Handling] Loaded " << data.size() << " events from " << filename << std::endl;
+    }
+
 
 } // Namespace nexus is closed
\ No newline at end of file
@@ -27,6 +27,8 @@ namespace filehandler{
 
             // Get event data from csv
             void GetEvent(string filename, vector<vector<G4double>> &data);
+            // Same rows (x, y, z, value) grouped by the event column, in event order
+            void GetEventGroups(string filename, vector<vector<vector<G4double>>> &data);
 
 
             // This is for wrting detector counts to a text file
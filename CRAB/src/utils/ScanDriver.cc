@@ -0,0 +1,86 @@
+#include "ScanDriver.hh"
+#include "GasModelParameters.hh"
+#include "Analysis.hh"
+
+#include "G4UImanager.hh"
+#include "G4UIcommand.hh"
+#include "G4Tokenizer.hh"
+
+#include <chrono>
+
+namespace scan {
+
+    ScanDriver::ScanDriver(GasModelParameters* gmp) : fGasModelParameters(gmp) {
+        msg_ = new G4GenericMessenger(this, "/Scan/", "Control of in-process parameter scans.");
+        msg_->DeclareMethod("addPoint", &ScanDriver::AddPoint,
+                            "Add a scan point: pressure[bar] fieldDrift[V/cm] fieldLEM[V/cm] gapLEM[cm]");
+        msg_->DeclareMethod("clear", &ScanDriver::Clear, "Remove all scan points");
+        msg_->DeclareMethod("run", &ScanDriver::Run, "Run the given number of events at every scan point");
+    }
+
+    ScanDriver::~ScanDriver(){
+        delete msg_;
+    }
+
+    void ScanDriver::AddPoint(G4String values){
+        G4Tokenizer next(values);
+        ScanPoint point;
+        point.pressure   = G4UIcommand::ConvertToDouble(next());
+        point.fieldDrift = G4UIcommand::ConvertToDouble(next());
+        point.fieldLEM   = G4UIcommand::ConvertToDouble(next());
+        point.gapLEM     = G4UIcommand::ConvertToDouble(next());
+
+        if (point.pressure <= 0. || point.gapLEM <= 0.)
+            G4Exception("[ScanDriver]", "AddPoint()", FatalException,
+                        ("Invalid scan point: " + values).c_str());
+
+        points_.push_back(point);
+    }
+
+    void ScanDriver::Clear(){
+        points_.clear();
+    }
+
+    void ScanDriver::Run(G4int nevents){
+        if (points_.empty()){
+            G4cout << "ScanDriver: no scan points defined, use /Scan/addPoint" << G4endl;
+            return;
+        }
+
+        G4UImanager* UImanager = G4UImanager::GetUIpointer();
+        G4String baseName = G4AnalysisManager::Instance()->GetFileName();
+        if (baseName.empty()) baseName = "output";
+        // Strip the extension so the tag goes before it
+        std::size_t dot = baseName.rfind(".root");
+        if (dot != std::string::npos) baseName = baseName.substr(0, dot);
+
+        for (std::size_t i = 0; i < points_.size(); i++){
+            const ScanPoint& point = points_[i];
+
+            auto start = std::chrono::high_resolution_clock::now();
+
+            // The detector swaps in a gas material at the new density, the
+            // Garfield model picks up the rest at its next DoIt()
+            UImanager->ApplyCommand("/Xenon/geometry/SetGasPressure " + G4UIcommand::ConvertToString(point.pressure) + " bar");
+            fGasModelParameters->SetFieldDrift(point.fieldDrift);
+            fGasModelParameters->SetFieldLEM(point.fieldLEM);
+            fGasModelParameters->SetGapLEM(point.gapLEM);
+            fGasModelParameters->NewScanPoint();
+
+            UImanager->ApplyCommand("/analysis/setFileName " + baseName + "_scan" + std::to_string(i));
+
+            G4cout << "ScanDriver: point " << i << " P = " << point.pressure << " bar, drift field = "
+                   << point.fieldDrift << " V/cm, EL field = " << point.fieldLEM << " V/cm, EL gap = "
+                   << point.gapLEM << " cm" << G4endl;
+
+            UImanager->ApplyCommand("/run/beamOn " + std::to_string(nevents));
+
+            auto end = std::chrono::high_resolution_clock::now();
+            G4cout << "ScanDriver: point " << i << " took "
+                   << std::chrono::duration<G4double>(end - start).count() << " s" << G4endl;
+        }
+
+        // Leave the file name as it was for any later runs
+        UImanager->ApplyCommand("/analysis/setFileName " + baseName);
+    }
+}
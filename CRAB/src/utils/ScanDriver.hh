@@ -0,0 +1,45 @@
+//
+// Runs a grid of (pressure, drift field, EL field, EL gap) points in a single
+// process. Between points only the gas material and the Garfield medium/field
+// settings are updated, everything else stays initialised. Each point writes
+// to its own output file tagged with the point index.
+//
+
+#ifndef ScanDriver_hh
+#define ScanDriver_hh 1
+
+#include "globals.hh"
+#include "G4GenericMessenger.hh"
+#include <vector>
+
+class GasModelParameters;
+
+namespace scan {
+
+    struct ScanPoint {
+        G4double pressure;   // bar
+        G4double fieldDrift; // V/cm
+        G4double fieldLEM;   // V/cm
+        G4double gapLEM;     // cm
+    };
+
+    class ScanDriver {
+        public:
+            ScanDriver(GasModelParameters*);
+            ~ScanDriver();
+
+            // "pressure[bar] fieldDrift[V/cm] fieldLEM[V/cm] gapLEM[cm]"
+            void AddPoint(G4String);
+            void Clear();
+
+            // Run nevents at every point
+            void Run(G4int nevents);
+
+        private:
+            G4GenericMessenger *msg_;
+            GasModelParameters* fGasModelParameters;
+            std::vector<ScanPoint> points_;
+    };
+}
+
+#endif
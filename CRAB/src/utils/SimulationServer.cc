@@ -0,0 +1,142 @@
+#include "SimulationServer.hh"
+
+#include "G4UImanager.hh"
+#include "G4RunManager.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace simserver {
+
+    namespace fs = std::filesystem;
+
+    SimulationServer::SimulationServer(const G4String& spoolDir, G4long baseSeed):
+        UImanager_(G4UImanager::GetUIpointer()),
+        spoolDir_(spoolDir.c_str()),
+        baseSeed_(baseSeed),
+        nJobs_(0),
+        nFailed_(0),
+        pollInterval_(500),
+        initTime_(0.),
+        jobTime_(0.)
+    {
+        if (!fs::is_directory(spoolDir_))
+            G4Exception("[SimulationServer]", "SimulationServer()", FatalException,
+                        ("Spool directory " + spoolDir + " does not exist").c_str());
+
+        // Jobs are moved to running/ while being processed and to done/ afterwards,
+        // or to failed/ when one of their commands failed
+        runningDir_ = spoolDir_ / "running";
+        doneDir_    = spoolDir_ / "done";
+        failedDir_  = spoolDir_ / "failed";
+        outputDir_  = spoolDir_ / "output";
+        fs::create_directories(runningDir_);
+        fs::create_directories(doneDir_);
+        fs::create_directories(failedDir_);
+        fs::create_directories(outputDir_);
+    }
+
+    void SimulationServer::Initialise(const G4String& initMacro){
+        auto start = std::chrono::high_resolution_clock::now();
+
+        G4cout << "SimulationServer: initialising with " << initMacro << G4endl;
+        UImanager_->ApplyCommand("/control/execute " + initMacro);
+
+        // Make sure the kernel is built even if the init macro forgot it
+        if (!G4RunManager::GetRunManager()->GetUserDetectorConstruction())
+            G4Exception("[SimulationServer]", "Initialise()", FatalException,
+                        "No detector construction was registered");
+        UImanager_->ApplyCommand("/run/initialize");
+
+        auto end = std::chrono::high_resolution_clock::now();
+        initTime_ = std::chrono::duration<G4double>(end - start).count();
+        G4cout << "SimulationServer: initialisation took " << initTime_ << " s" << G4endl;
+    }
+
+    std::vector<fs::path> SimulationServer::PendingJobs() const {
+        std::vector<fs::path> jobs;
+        for (const auto& entry : fs::directory_iterator(spoolDir_)){
+            if (entry.is_regular_file() && entry.path().extension() == ".mac" && !skipped_.count(entry.path()))
+                jobs.push_back(entry.path());
+        }
+        // Process in name order so that submitters can control the sequence
+        std::sort(jobs.begin(), jobs.end());
+        return jobs;
+    }
+
+    void SimulationServer::RunJob(const fs::path& job){
+        // Claim the job before running it so that it is not picked up twice
+        fs::path running = runningDir_ / job.filename();
+        std::error_code ec;
+        fs::rename(job, running, ec);
+        if (ec){
+            // Removed by the submitter or not ours to move, do not try it again
+            G4Exception("[SimulationServer]", "RunJob()", JustWarning,
+                        ("Could not claim job " + job.string() + ": " + ec.message() + ", skipped").c_str());
+            skipped_.insert(job);
+            return;
+        }
+
+        G4long seed = baseSeed_ + nJobs_;
+        G4Random::setTheSeed(seed);
+
+        // Default output name follows the job, the macro may still override it
+        fs::path output = outputDir_ / job.stem();
+        UImanager_->ApplyCommand("/analysis/setFileName " + G4String(output.string()));
+
+        G4cout << "SimulationServer: job " << nJobs_ << " " << job.filename().string()
+               << " seed " << seed << G4endl;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        G4int status = UImanager_->ApplyCommand("/control/execute " + G4String(running.string()));
+        auto end = std::chrono::high_resolution_clock::now();
+        G4double duration = std::chrono::duration<G4double>(end - start).count();
+
+        jobTime_ += duration;
+        nJobs_++;
+
+        G4cout << "SimulationServer: job " << job.filename().string() << " took " << duration
+               << " s (start-up saved: " << initTime_ << " s)" << G4endl;
+
+        // A failed command aborts the rest of the macro, keep such jobs apart
+        fs::path finished = doneDir_ / job.filename();
+        if (status != 0){
+            nFailed_++;
+            finished = failedDir_ / job.filename();
+            G4Exception("[SimulationServer]", "RunJob()", JustWarning,
+                        ("Job " + job.filename().string() + " returned command status " + std::to_string(status)
+                         + ", moved to " + failedDir_.string()).c_str());
+        }
+
+        fs::rename(running, finished, ec);
+        if (ec)
+            G4Exception("[SimulationServer]", "RunJob()", JustWarning,
+                        ("Could not move " + running.string() + " to " + finished.string() + ": " + ec.message()).c_str());
+    }
+
+    void SimulationServer::Serve(){
+        fs::path stopFile = spoolDir_ / "STOP";
+        G4cout << "SimulationServer: watching " << spoolDir_.string()
+               << " (touch " << stopFile.string() << " to stop)" << G4endl;
+
+        while (!fs::exists(stopFile)){
+            std::vector<fs::path> jobs = PendingJobs();
+            if (jobs.empty()){
+                std::this_thread::sleep_for(std::chrono::milliseconds(pollInterval_));
+                continue;
+            }
+            for (const auto& job : jobs){
+                RunJob(job);
+                if (fs::exists(stopFile)) break;
+            }
+        }
+
+        fs::remove(stopFile);
+        G4cout << "SimulationServer: processed " << nJobs_ << " jobs (" << nFailed_ << " failed) in " << jobTime_
+               << " s after a single initialisation of " << initTime_ << " s" << G4endl;
+    }
+}
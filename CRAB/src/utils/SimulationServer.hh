@@ -0,0 +1,54 @@
+//
+// Persistent server mode for CRAB. The geometry, physics lists, Magboltz gas
+// tables and field maps are built once by an initialisation macro, then job
+// macros dropped into a spool directory are executed one after the other with
+// their own random seed and output file.
+//
+
+#ifndef SimulationServer_hh
+#define SimulationServer_hh 1
+
+#include "globals.hh"
+#include <filesystem>
+#include <set>
+#include <vector>
+
+class G4UImanager;
+
+namespace simserver {
+    class SimulationServer {
+        public:
+            // spoolDir is the watched directory, baseSeed the seed of the first job
+            SimulationServer(const G4String& spoolDir, G4long baseSeed);
+            ~SimulationServer() = default;
+
+            // Execute the macro that builds everything shared between jobs
+            void Initialise(const G4String& initMacro);
+
+            // Poll the spool directory until a STOP file appears
+            void Serve();
+
+            inline void SetPollInterval(G4int ms){ pollInterval_ = ms; }
+
+        private:
+            std::vector<std::filesystem::path> PendingJobs() const;
+            void RunJob(const std::filesystem::path& job);
+
+            G4UImanager* UImanager_;
+            std::filesystem::path spoolDir_;
+            std::filesystem::path runningDir_;
+            std::filesystem::path doneDir_;
+            std::filesystem::path failedDir_;
+            std::filesystem::path outputDir_;
+            G4long baseSeed_;
+            G4int nJobs_;
+            G4int nFailed_;
+            G4int pollInterval_;
+            G4double initTime_;
+            G4double jobTime_;
+            // Jobs that could not be claimed, left in the spool directory
+            std::set<std::filesystem::path> skipped_;
+    };
+}
+
+#endif
@@ -0,0 +1,73 @@
+//
+// Tabulated EL response of a single drift electron, used by the table mode of
+// GarfieldVUVPhotonModel in place of AvalancheMicroscopic. The table is made
+// offline by xenon_eltable (tools/MakeELTable.cc), which runs microscopic
+// avalanches over a grid of reduced field E/p and gap length. For every grid
+// point it stores the quantiles of the number of excitations per electron and
+// of the position of the excitations along the gap, the transit time with its
+// spread, the transverse spread at the end of the gap and the fraction of the
+// excitations in every Xenon level (kept for validation).
+//
+// Binary layout (native little endian):
+//   "XEELTAB1", int32 nEp, nGap, nQuantiles, nLevels, int32 firstLevel,
+//   double ep[nEp] (V/cm/bar), double gap[nGap] (cm), then per point
+//   (ep major) double count[nQ], position[nQ] (fraction of the gap),
+//   transit (ns), transitSigma (ns), transverseSigma (cm), levels[nLevels]
+//
+
+#ifndef ELYieldTable_hh
+#define ELYieldTable_hh
+
+#include "globals.hh"
+
+#include <vector>
+
+class ELYieldTable{
+	public:
+
+	struct Point{
+		std::vector<G4double> count;
+		std::vector<G4double> position;
+		G4double transit;
+		G4double transitSigma;
+		G4double transverseSigma;
+		std::vector<G4double> levels;
+	};
+
+	// Interpolated response for one E/p and gap length
+	struct Response{
+		const Point* p[4];
+		G4double w[4];
+	};
+
+	ELYieldTable();
+	~ELYieldTable(){};
+
+	void Load(const G4String& file);
+	void Write(const G4String& file) const;
+	inline G4bool IsLoaded() const {return !fPoints.empty();};
+
+	// Bilinear weights of the grid points around (ep, gap), clamped to the grid
+	Response GetResponse(G4double ep_Vcmbar, G4double gap_cm) const;
+
+	// Random draws from the interpolated quantiles
+	G4int SampleExcitations(const Response&) const;
+	G4double SamplePosition(const Response&) const;
+	G4double Mean(const Response&, G4double Point::* member) const;
+
+	// Grid and points, filled by the table maker
+	std::vector<G4double> fEp;
+	std::vector<G4double> fGap;
+	G4int fNQuantiles;
+	G4int fNLevels;
+	G4int fFirstLevel;
+	std::vector<Point> fPoints;
+
+	inline Point& At(size_t iEp, size_t iGap){return fPoints[iEp*fGap.size() + iGap];};
+
+	private:
+	G4double Quantile(const Response&, std::vector<G4double> Point::* member, G4double u) const;
+	static void Bracket(const std::vector<G4double>& grid, G4double x, size_t& i, G4double& f);
+};
+
+#endif
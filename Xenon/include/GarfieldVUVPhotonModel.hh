@@ -36,6 +36,7 @@
 #include "GasBoxSD.hh"
 #include "MediumMagboltz.hh"
 #include "AvalancheMicroscopic.hh"
+#include "ELYieldTable.hh"
 
 class GasModelParameters;
 class DetectorConstruction;
@@ -57,6 +58,8 @@ public:
 	virtual G4bool ModelTrigger(const G4FastTrack &);
 	virtual void DoIt(const G4FastTrack&, G4FastStep&);
 	void GenerateVUVPhotons(const G4FastTrack& fastTrack, G4FastStep& fastStep,G4ThreeVector garfPos,G4double garfTime);
+	// Same light sampled from the tabulated single electron response
+	void GenerateVUVPhotonsFromTable(G4FastStep& fastStep,G4ThreeVector garfPos,G4double garfTime);
 	G4ThreeVector garfPos;
 	G4double garfTime;
 	
@@ -64,6 +67,8 @@ public:
 	
 private:
 	void InitialisePhysics();
+	// Records an excitation and puts its photon on the stack (one in ten)
+	void AddExcitation(G4FastStep& fastStep,G4ThreeVector pos,G4double t,G4int i,G4int n);
 
 	DetectorConstruction* detCon;
 	G4ThreeVector myPoint;
@@ -75,6 +80,14 @@ private:
 	Garfield::AvalancheMicroscopic* fAvalanche;
 
 	GasBoxSD* fGasBoxSD;
+
+	GasModelParameters* fGasModelParameters;
+	G4bool fUseTable;
+	ELYieldTable fELTable;
+	// EL slab of the Garfield geometry, the tube is along y
+	G4double fELBottom;
+	G4double fELTop;
+	G4double fELRadius;
 };
 
 void userHandle(double x, double y, double z, double t, int type, int level,Garfield::Medium * m);
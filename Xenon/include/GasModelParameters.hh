@@ -19,11 +19,20 @@ class GasModelParameters{
     /*Getters and Setters*/
     inline void SetThermalEnergy(G4double d){thermalE=d;}
     inline G4double GetThermalEnergy(){return thermalE;};
+    inline void SetELMode(G4String s){elMode=s;}
+    inline G4String GetELMode(){return elMode;};
+    inline void SetELTable(G4String s){elTable=s;}
+    inline G4String GetELTable(){return elTable;};
+    inline void SetELField(G4double d){elField=d;}
+    inline G4double GetELField(){return elField;};
 
 	
 	private:
 	GasModelParametersMessenger* fMessenger;
     G4double thermalE;
+    G4String elMode;   // microscopic (AvalancheMicroscopic) or table (ELYieldTable)
+    G4String elTable;
+    G4double elField;  // V/cm
 
 };
 
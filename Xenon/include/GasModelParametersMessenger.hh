@@ -30,8 +30,12 @@ class GasModelParametersMessenger : public G4UImessenger {
   GasModelParameters* fGasModelParameters;
   G4UIdirectory* GasModelParametersDir;
   G4UIdirectory* DegradDir;
+  G4UIdirectory* GarfieldDir;
 
   G4UIcmdWithADoubleAndUnit* thermalEnergyCmd;
+  G4UIcmdWithAString* elModeCmd;
+  G4UIcmdWithAString* elTableCmd;
+  G4UIcmdWithADouble* elFieldCmd;
   
 };
 
@@ -0,0 +1,127 @@
+#include "ELYieldTable.hh"
+
+#include "Randomize.hh"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+ELYieldTable::ELYieldTable() : fNQuantiles(0), fNLevels(0), fFirstLevel(0) {}
+
+void ELYieldTable::Load(const G4String& file){
+	std::ifstream in(file, std::ios::binary);
+	if (!in.is_open())
+		G4Exception("[ELYieldTable]", "Load()", FatalException,
+					("Could not open EL table " + file).c_str());
+
+	char magic[8];
+	in.read(magic, 8);
+	if (!in || std::strncmp(magic, "XEELTAB1", 8) != 0)
+		G4Exception("[ELYieldTable]", "Load()", FatalException,
+					(file + " is not an EL table, make it with xenon_eltable").c_str());
+
+	int32_t header[5];
+	in.read(reinterpret_cast<char*>(header), sizeof(header));
+	fNQuantiles = header[2];
+	fNLevels = header[3];
+	fFirstLevel = header[4];
+	fEp.resize(header[0]);
+	fGap.resize(header[1]);
+	in.read(reinterpret_cast<char*>(fEp.data()), fEp.size()*sizeof(G4double));
+	in.read(reinterpret_cast<char*>(fGap.data()), fGap.size()*sizeof(G4double));
+
+	fPoints.resize(fEp.size()*fGap.size());
+	for (auto& p : fPoints){
+		p.count.resize(fNQuantiles);
+		p.position.resize(fNQuantiles);
+		p.levels.resize(fNLevels);
+		in.read(reinterpret_cast<char*>(p.count.data()), fNQuantiles*sizeof(G4double));
+		in.read(reinterpret_cast<char*>(p.position.data()), fNQuantiles*sizeof(G4double));
+		in.read(reinterpret_cast<char*>(&p.transit), sizeof(G4double));
+		in.read(reinterpret_cast<char*>(&p.transitSigma), sizeof(G4double));
+		in.read(reinterpret_cast<char*>(&p.transverseSigma), sizeof(G4double));
+		in.read(reinterpret_cast<char*>(p.levels.data()), fNLevels*sizeof(G4double));
+	}
+
+	if (!in || fPoints.empty())
+		G4Exception("[ELYieldTable]", "Load()", FatalException,
+					(file + " is truncated").c_str());
+
+	G4cout << "ELYieldTable: " << fEp.size() << " E/p x " << fGap.size() << " gap points from " << file << G4endl;
+}
+
+void ELYieldTable::Write(const G4String& file) const{
+	std::ofstream out(file, std::ios::binary);
+	if (!out.is_open())
+		G4Exception("[ELYieldTable]", "Write()", FatalException,
+					("Could not write EL table " + file).c_str());
+
+	out.write("XEELTAB1", 8);
+	int32_t header[5] = {(int32_t)fEp.size(), (int32_t)fGap.size(), fNQuantiles, fNLevels, fFirstLevel};
+	out.write(reinterpret_cast<const char*>(header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(fEp.data()), fEp.size()*sizeof(G4double));
+	out.write(reinterpret_cast<const char*>(fGap.data()), fGap.size()*sizeof(G4double));
+	for (const auto& p : fPoints){
+		out.write(reinterpret_cast<const char*>(p.count.data()), fNQuantiles*sizeof(G4double));
+		out.write(reinterpret_cast<const char*>(p.position.data()), fNQuantiles*sizeof(G4double));
+		out.write(reinterpret_cast<const char*>(&p.transit), sizeof(G4double));
+		out.write(reinterpret_cast<const char*>(&p.transitSigma), sizeof(G4double));
+		out.write(reinterpret_cast<const char*>(&p.transverseSigma), sizeof(G4double));
+		out.write(reinterpret_cast<const char*>(p.levels.data()), fNLevels*sizeof(G4double));
+	}
+}
+
+void ELYieldTable::Bracket(const std::vector<G4double>& grid, G4double x, size_t& i, G4double& f){
+	if (grid.size() == 1 || x <= grid.front()){ i = 0; f = 0.; return; }
+	if (x >= grid.back()){ i = grid.size() - 2; f = 1.; return; }
+	i = 0;
+	while (grid[i + 1] < x) i++;
+	f = (x - grid[i])/(grid[i + 1] - grid[i]);
+}
+
+ELYieldTable::Response ELYieldTable::GetResponse(G4double ep, G4double gap) const{
+	size_t i, j;
+	G4double fe, fg;
+	Bracket(fEp, ep, i, fe);
+	Bracket(fGap, gap, j, fg);
+	size_t i1 = std::min(i + 1, fEp.size() - 1);
+	size_t j1 = std::min(j + 1, fGap.size() - 1);
+	size_t nGap = fGap.size();
+
+	Response r;
+	r.p[0] = &fPoints[i*nGap + j];   r.w[0] = (1. - fe)*(1. - fg);
+	r.p[1] = &fPoints[i1*nGap + j];  r.w[1] = fe*(1. - fg);
+	r.p[2] = &fPoints[i*nGap + j1];  r.w[2] = (1. - fe)*fg;
+	r.p[3] = &fPoints[i1*nGap + j1]; r.w[3] = fe*fg;
+	return r;
+}
+
+G4double ELYieldTable::Quantile(const Response& r, std::vector<G4double> Point::* member, G4double u) const{
+	// Quantile functions are interpolated, which keeps the shape of the distributions
+	G4double q = u*(fNQuantiles - 1);
+	G4int k = std::min((G4int)q, fNQuantiles - 2);
+	G4double f = q - k;
+	G4double value = 0.;
+	for (G4int c = 0; c < 4; c++){
+		if (r.w[c] == 0.) continue;
+		const std::vector<G4double>& v = r.p[c]->*member;
+		value += r.w[c]*((1. - f)*v[k] + f*v[k + 1]);
+	}
+	return value;
+}
+
+G4int ELYieldTable::SampleExcitations(const Response& r) const{
+	G4double n = Quantile(r, &Point::count, G4UniformRand());
+	G4int whole = (G4int)std::floor(n);
+	return whole + (G4UniformRand() < n - whole ? 1 : 0);
+}
+
+G4double ELYieldTable::SamplePosition(const Response& r) const{
+	return Quantile(r, &Point::position, G4UniformRand());
+}
+
+G4double ELYieldTable::Mean(const Response& r, G4double Point::* member) const{
+	G4double value = 0.;
+	for (G4int c = 0; c < 4; c++) value += r.w[c]*(r.p[c]->*member);
+	return value;
+}
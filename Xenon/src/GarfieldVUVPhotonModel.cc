@@ -30,9 +30,12 @@
 const static G4double torr = 1. / 760. * atmosphere;
 
 GarfieldVUVPhotonModel::GarfieldVUVPhotonModel(GasModelParameters* gmp, G4String modelName,G4Region* envelope,DetectorConstruction* dc,GasBoxSD* sd) :
-		G4VFastSimulationModel(modelName, envelope),detCon(dc),fGasBoxSD(sd) {
+		G4VFastSimulationModel(modelName, envelope),detCon(dc),fGasBoxSD(sd),fGasModelParameters(gmp) {
 	thermalE=gmp->GetThermalEnergy();
+	fUseTable = gmp->GetELMode()=="table";
 	InitialisePhysics();
+	if (fUseTable)
+		fELTable.Load(gmp->GetELTable());
 }
 
 G4bool GarfieldVUVPhotonModel::IsApplicable(const G4ParticleDefinition& particleType) {
@@ -83,7 +86,10 @@ void GarfieldVUVPhotonModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fast
      //G4cout<<"GLOBAL TIME "<<G4BestUnit(garfTime,"Time")<<" POSITION "<<G4BestUnit(garfPos,"Length")<<G4endl;
 
 
-    GenerateVUVPhotons(fastTrack,fastStep,garfPos,garfTime);
+    if (fUseTable)
+      GenerateVUVPhotonsFromTable(fastStep,garfPos,garfTime);
+    else
+      GenerateVUVPhotons(fastTrack,fastStep,garfPos,garfTime);
     G4cout<<"HELLO Garfield 3"<<G4endl;
 
 }
@@ -110,23 +116,55 @@ void GarfieldVUVPhotonModel::GenerateVUVPhotons(const G4FastTrack& fastTrack, G4
 	G4int colHitsEntries=garfExcHitsCol->entries();
 	G4cout<<"GarfExcHits entries "<<colHitsEntries<<G4endl; // This one is not cumulative.
 	
-	for (G4int i=0;i<colHitsEntries;i++){
-	  GarfieldExcitationHit* newExcHit=new GarfieldExcitationHit();
-	  newExcHit->SetPos((*garfExcHitsCol)[i]->GetPos());
-	  newExcHit->SetTime((*garfExcHitsCol)[i]->GetTime());
-	  fGasBoxSD->InsertGarfieldExcitationHit(newExcHit);
-	  // fastStep.SetNumberOfSecondaryTracks(1);	//1 photon per excitation .... Must be commented when I comment below condition too.
-	  if(i % (colHitsEntries/10) == 0){ // Need to uncomment this condition, along with one in degradmodel.cc. EC, 2-Dec-2021.
-	    G4DynamicParticle VUVphoton(G4OpticalPhoton::OpticalPhotonDefinition(),G4RandomDirection(), 7.2*eV);
-	    // Create photons track
-	    G4Track *newTrack=fastStep.CreateSecondaryTrack(VUVphoton, (*garfExcHitsCol)[i]->GetPos(),(*garfExcHitsCol)[i]->GetTime(),false);
-	    G4ProcessManager* pm= newTrack->GetDefinition()->GetProcessManager();
-	    //	G4ProcessVectorfAtRestDoItVector = pm->GetAtRestProcessVector(typeDoIt);
-	    //G4ProcessVectorfVector gpv = pm->GetAtRestProcessVector(typeGPIL);
-	    }						
-	}
+	for (G4int i=0;i<colHitsEntries;i++)
+	  AddExcitation(fastStep,(*garfExcHitsCol)[i]->GetPos(),(*garfExcHitsCol)[i]->GetTime(),i,colHitsEntries);
 	delete garfExcHitsCol;
 }
+
+void GarfieldVUVPhotonModel::GenerateVUVPhotonsFromTable(G4FastStep& fastStep,G4ThreeVector garfPos,G4double garfTime)
+{
+	// Outside the EL slab there is no Garfield medium, the avalanche would be empty
+	G4double r = std::sqrt(garfPos.x()*garfPos.x() + garfPos.z()*garfPos.z());
+	if (r > fELRadius || garfPos.y() < fELBottom || garfPos.y() >= fELTop)
+		return;
+
+	// Electrons drift along +y through the rest of the gap
+	G4double gap = fELTop - garfPos.y();
+	G4double ep = fGasModelParameters->GetELField()/(detCon->GetGasPressure()/bar);
+	ELYieldTable::Response response = fELTable.GetResponse(ep, gap/cm);
+
+	G4int n = fELTable.SampleExcitations(response);
+	G4double transit = fELTable.Mean(response, &ELYieldTable::Point::transit)*ns;
+	G4double transitSigma = fELTable.Mean(response, &ELYieldTable::Point::transitSigma)*ns;
+	G4double transverseSigma = fELTable.Mean(response, &ELYieldTable::Point::transverseSigma)*cm;
+
+	G4cout<<"NExcitation (table) "<<n<<G4endl;
+
+	for (G4int i=0;i<n;i++){
+	  // Spreads grow as the square root of the distance drifted
+	  G4double f = fELTable.SamplePosition(response);
+	  G4double s = std::sqrt(f);
+	  G4ThreeVector pos(garfPos.x() + G4RandGauss::shoot(0., transverseSigma*s),
+			    garfPos.y() + f*gap,
+			    garfPos.z() + G4RandGauss::shoot(0., transverseSigma*s));
+	  G4double t = garfTime + f*transit + G4RandGauss::shoot(0., transitSigma*s);
+	  AddExcitation(fastStep,pos,t,i,n);
+	}
+}
+
+void GarfieldVUVPhotonModel::AddExcitation(G4FastStep& fastStep,G4ThreeVector pos,G4double t,G4int i,G4int n)
+{
+	GarfieldExcitationHit* newExcHit=new GarfieldExcitationHit();
+	newExcHit->SetPos(pos);
+	newExcHit->SetTime(t);
+	fGasBoxSD->InsertGarfieldExcitationHit(newExcHit);
+	// fastStep.SetNumberOfSecondaryTracks(1);	//1 photon per excitation .... Must be commented when I comment below condition too.
+	if(i % std::max(1, n/10) == 0){ // Need to uncomment this condition, along with one in degradmodel.cc. EC, 2-Dec-2021.
+	  G4DynamicParticle VUVphoton(G4OpticalPhoton::OpticalPhotonDefinition(),G4RandomDirection(), 7.2*eV);
+	  // Create photons track
+	  fastStep.CreateSecondaryTrack(VUVphoton, pos, t, false);
+	}
+}
 // Selection of Xenon exitations and ionizations
 
 void GarfieldVUVPhotonModel::InitialisePhysics(){
@@ -149,13 +187,16 @@ void GarfieldVUVPhotonModel::InitialisePhysics(){
 	std::cout << "GarfieldVUVPhotonModel::InitPhys(): 1" << std::endl;
 	// Add the solid to the geometry, together with the medium inside
 	geo->AddSolid(tube, fMediumMagboltz);
+	fELBottom = detectorHalfZ*2.0;
+	fELTop = detectorHalfZ*2.0 + detectorHalfZ*2.*0.05;
+	fELRadius = detectorRadius;
 	std::cout << "GarfieldVUVPhotonModel::InitPhys(): 2" << std::endl;
 	// Make a component with analytic electric field
 	Garfield::ComponentConstant* componentConstant = new Garfield::ComponentConstant();
 	componentConstant->SetGeometry(geo);
 	//SetElectricField(const double ex, const double ey, const double ez);
 
-	componentConstant->SetElectricField(0.,-3000.0,0.);
+	componentConstant->SetElectricField(0.,-fGasModelParameters->GetELField(),0.);
 	std::cout << "GarfieldVUVPhotonModel::InitPhys(): 3" << std::endl;
 
 	// Make a sensor
@@ -3,6 +3,7 @@
 #include "GasModelParametersMessenger.hh"
 #include "DetectorConstruction.hh"
 
-GasModelParameters::GasModelParameters(){
+GasModelParameters::GasModelParameters() :
+	elMode("microscopic"), elTable("ELTable.bin"), elField(3000.) {
 	fMessenger = new GasModelParametersMessenger(this);
 }
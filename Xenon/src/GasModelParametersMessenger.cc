@@ -27,6 +27,19 @@ GasModelParametersMessenger::GasModelParametersMessenger(GasModelParameters* gm)
 
   thermalEnergyCmd = new G4UIcmdWithADoubleAndUnit("/gasModelParameters/degrad/thermalenergy",this);
   thermalEnergyCmd->SetGuidance("Set the thermal energy to be used by degrad");
+
+  GarfieldDir = new G4UIdirectory("/gasModelParameters/garfield/");
+  GarfieldDir->SetGuidance("Garfield EL specific controls");
+
+  elModeCmd = new G4UIcmdWithAString("/gasModelParameters/garfield/elMode",this);
+  elModeCmd->SetGuidance("EL light per electron from microscopic avalanches or from the tabulated yield");
+  elModeCmd->SetCandidates("microscopic table");
+
+  elTableCmd = new G4UIcmdWithAString("/gasModelParameters/garfield/elTable",this);
+  elTableCmd->SetGuidance("EL yield table made by xenon_eltable");
+
+  elFieldCmd = new G4UIcmdWithADouble("/gasModelParameters/garfield/elField",this);
+  elFieldCmd->SetGuidance("Field in the EL gap in V/cm");
   
 }
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -35,6 +48,10 @@ GasModelParametersMessenger::~GasModelParametersMessenger() {
   delete GasModelParametersDir;
   delete DegradDir;
   delete thermalEnergyCmd;
+  delete GarfieldDir;
+  delete elModeCmd;
+  delete elTableCmd;
+  delete elFieldCmd;
 
 }
 
@@ -44,5 +61,14 @@ void GasModelParametersMessenger::SetNewValue(G4UIcommand* command, G4String new
     if(command == thermalEnergyCmd){
       fGasModelParameters->SetThermalEnergy(thermalEnergyCmd->GetNewDoubleValue(newValues));
     }
+    else if(command == elModeCmd){
+      fGasModelParameters->SetELMode(newValues);
+    }
+    else if(command == elTableCmd){
+      fGasModelParameters->SetELTable(newValues);
+    }
+    else if(command == elFieldCmd){
+      fGasModelParameters->SetELField(elFieldCmd->GetNewDoubleValue(newValues));
+    }
 
 }
@@ -0,0 +1,162 @@
+// xenon_eltable: microscopic EL avalanches over a grid of E/p and gap length,
+// summarised into the table read by the table mode of GarfieldVUVPhotonModel.
+//
+// Usage: xenon_eltable [-p pressure_bar] [-T temperature_K] [-n electrons]
+//                      [-e ep1,ep2,... (V/cm/bar)] [-g gap1,gap2,... (cm)]
+//                      [-o ELTable.bin]
+
+#include "ELYieldTable.hh"
+
+#include "AvalancheMicroscopic.hh"
+#include "ComponentConstant.hh"
+#include "GeometrySimple.hh"
+#include "MediumMagboltz.hh"
+#include "Sensor.hh"
+#include "SolidBox.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+	// Same level selection as userHandle in GarfieldVUVPhotonModel
+	const int kFirstLevel = 3;
+	const int kNLevels = 50;
+	const int kNQuantiles = 101;
+
+	struct Excitation { double y, x, z, t; int level; };
+	std::vector<Excitation> excitations;
+
+	void handle(double x, double y, double z, double t, int, int level, Garfield::Medium*){
+		if (level >= kFirstLevel && level < kFirstLevel + kNLevels)
+			excitations.push_back({y, x, z, t, level});
+	}
+
+	std::vector<double> ParseList(const std::string& s){
+		std::vector<double> v;
+		std::stringstream ss(s);
+		std::string item;
+		while (std::getline(ss, item, ',')) v.push_back(std::stod(item));
+		std::sort(v.begin(), v.end());
+		return v;
+	}
+
+	std::vector<double> Quantiles(std::vector<double> values){
+		std::vector<double> q(kNQuantiles, 0.);
+		if (values.empty()) return q;
+		std::sort(values.begin(), values.end());
+		for (int k = 0; k < kNQuantiles; k++){
+			double pos = k*(values.size() - 1.)/(kNQuantiles - 1.);
+			size_t i = std::min((size_t)pos, values.size() - 1);
+			size_t i1 = std::min(i + 1, values.size() - 1);
+			q[k] = values[i] + (pos - i)*(values[i1] - values[i]);
+		}
+		return q;
+	}
+}
+
+int main(int argc, char** argv){
+
+	double pressure = 10.;   // bar
+	double temperature = 293.15;
+	int nElectrons = 200;
+	std::string output = "ELTable.bin";
+	std::vector<double> eps = {500., 1000., 1500., 2000., 2500., 3000., 3500., 4000.};
+	std::vector<double> gaps = {0.01, 0.02, 0.05, 0.1, 0.2, 0.3, 0.5};
+
+	for (int i = 1; i < argc; i++){
+		std::string arg = argv[i];
+		if (arg == "-p" && i + 1 < argc)      pressure = std::stod(argv[++i]);
+		else if (arg == "-T" && i + 1 < argc) temperature = std::stod(argv[++i]);
+		else if (arg == "-n" && i + 1 < argc) nElectrons = std::stoi(argv[++i]);
+		else if (arg == "-e" && i + 1 < argc) eps = ParseList(argv[++i]);
+		else if (arg == "-g" && i + 1 < argc) gaps = ParseList(argv[++i]);
+		else if (arg == "-o" && i + 1 < argc) output = argv[++i];
+		else {
+			std::cerr << "Usage: xenon_eltable [-p pressure_bar] [-T temperature_K] [-n electrons]"
+					  << " [-e ep1,ep2,...] [-g gap1,gap2,...] [-o ELTable.bin]" << std::endl;
+			return 1;
+		}
+	}
+
+	Garfield::MediumMagboltz gas;
+	gas.SetComposition("Xe", 100.);
+	gas.SetTemperature(temperature);
+	gas.SetPressure(pressure*750.062);
+
+	ELYieldTable table;
+	table.fEp = eps;
+	table.fGap = gaps;
+	table.fNQuantiles = kNQuantiles;
+	table.fNLevels = kNLevels;
+	table.fFirstLevel = kFirstLevel;
+	table.fPoints.resize(eps.size()*gaps.size());
+
+	for (size_t ie = 0; ie < eps.size(); ie++){
+		for (size_t ig = 0; ig < gaps.size(); ig++){
+			double gap = gaps[ig];
+
+			// Slab of the gap along y, wide enough not to lose electrons sideways
+			Garfield::SolidBox box(0., 0.5*gap, 0., 10., 0.5*gap, 10.);
+			Garfield::GeometrySimple geo;
+			geo.AddSolid(&box, &gas);
+			Garfield::ComponentConstant field;
+			field.SetGeometry(&geo);
+			field.SetElectricField(0., -eps[ie]*pressure, 0.);
+			Garfield::Sensor sensor;
+			sensor.AddComponent(&field);
+
+			Garfield::AvalancheMicroscopic avalanche;
+			avalanche.SetSensor(&sensor);
+			avalanche.SetUserHandleInelastic(handle);
+
+			std::vector<double> counts, positions, transits, transverse;
+			std::vector<double> levels(kNLevels, 0.);
+			double nTotal = 0.;
+
+			for (int n = 0; n < nElectrons; n++){
+				excitations.clear();
+				// Same start as GarfieldVUVPhotonModel: 7 eV, isotropic
+				avalanche.AvalancheElectron(0., 1.e-6, 0., 0., 7., 0., 0., 0.);
+
+				counts.push_back(excitations.size());
+				double tLast = 0.;
+				for (const auto& e : excitations){
+					positions.push_back(std::min(1., std::max(0., e.y/gap)));
+					tLast = std::max(tLast, e.t);
+					if (e.y > 0.9*gap) transverse.push_back(0.5*(e.x*e.x + e.z*e.z));
+					levels[e.level - kFirstLevel] += 1.;
+				}
+				nTotal += excitations.size();
+				if (!excitations.empty()) transits.push_back(tLast);
+			}
+
+			ELYieldTable::Point& p = table.At(ie, ig);
+			p.count = Quantiles(counts);
+			p.position = Quantiles(positions);
+			p.levels = levels;
+			for (auto& l : p.levels) l = nTotal > 0. ? l/nTotal : 0.;
+
+			double mean = 0., mean2 = 0.;
+			for (double t : transits){ mean += t; mean2 += t*t; }
+			if (!transits.empty()){ mean /= transits.size(); mean2 /= transits.size(); }
+			p.transit = mean;
+			p.transitSigma = std::sqrt(std::max(0., mean2 - mean*mean));
+
+			double sumT = 0.;
+			for (double t : transverse) sumT += t;
+			p.transverseSigma = transverse.empty() ? 0. : std::sqrt(sumT/transverse.size());
+
+			std::cout << "xenon_eltable: E/p " << eps[ie] << " V/cm/bar, gap " << gap << " cm: "
+					  << nTotal/nElectrons << " excitations per electron, transit " << p.transit << " ns" << std::endl;
+		}
+	}
+
+	table.Write(output);
+	std::cout << "xenon_eltable: wrote " << output << std::endl;
+	return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * RadixFFTCheck.cc
+ *
+ * Standalone check of the two convolutions of WireSignalEngine::ProcessEvent:
+ * the direct sum used for short windows and the product of radixfft spectra
+ * used from 64 bins on. An ion-tail response and random arrivals on a few
+ * avalanche positions are convolved both ways for several window lengths,
+ * and the largest difference relative to the largest sample is printed.
+ * Needs no Geant4 or Garfield, see CMakeLists.txt in this directory.
+ */
+
+#include "RadixFFT.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Current of ions leaving an anode wire, 1/(t + t0) with a sign change to
+// mimic the induced current on a neighbouring electrode
+static std::vector<double> Response(int nBins) {
+    std::vector<double> r(nBins);
+    for (int b = 0; b < nBins; b++)
+        r[b] = -1./(1. + 0.5*b) + 0.2*std::exp(-0.05*b);
+    return r;
+}
+
+// Largest |fft - direct| over the largest |direct| for one window
+static double Compare(int nBins, int nCells, std::mt19937& rng) {
+    std::uniform_real_distribution<double> uniform(0., 1.);
+    std::vector<std::vector<double>> arrivals(nCells, std::vector<double>(nBins, 0.));
+    std::vector<std::vector<double>> responses(nCells);
+    for (int c = 0; c < nCells; c++) {
+        responses[c] = Response(nBins);
+        for (auto& v : responses[c]) v *= 1. + 0.1*c;
+        // Sparse arrivals as from a few Heed clusters, with the avalanche gain
+        for (int k = 0; k < nBins/8 + 1; k++)
+            arrivals[c][int(uniform(rng)*nBins)] += 1.e4*(0.5 + uniform(rng));
+    }
+
+    std::vector<double> direct(nBins, 0.);
+    for (int c = 0; c < nCells; c++)
+        radixfft::AddDirectConvolution(arrivals[c], responses[c], direct);
+
+    const std::size_t size = radixfft::Size(2*(std::size_t)nBins);
+    std::vector<radixfft::Complex> sum(size, 0.);
+    for (int c = 0; c < nCells; c++) {
+        std::vector<radixfft::Complex> a = radixfft::Spectrum(arrivals[c], size);
+        std::vector<radixfft::Complex> r = radixfft::Spectrum(responses[c], size);
+        for (std::size_t k = 0; k < size; k++) sum[k] += a[k]*r[k];
+    }
+    radixfft::Transform(sum, true);
+
+    double maxDiff = 0., maxValue = 0.;
+    for (int b = 0; b < nBins; b++) {
+        maxDiff = std::max(maxDiff, std::abs(sum[b].real() - direct[b]));
+        maxValue = std::max(maxValue, std::abs(direct[b]));
+    }
+    return maxValue > 0. ? maxDiff/maxValue : maxDiff;
+}
+
+int main() {
+    const double tolerance = 1.e-9;
+    std::mt19937 rng(12345);
+    int failed = 0;
+    for (int nBins : {1, 7, 63, 64, 100, 500, 1000, 4096}) {
+        double diff = Compare(nBins, 3, rng);
+        bool ok = diff < tolerance;
+        if (!ok) failed++;
+        std::printf("%5d bins: max relative difference %.3g %s\n", nBins, diff, ok ? "ok" : "FAILED");
+    }
+    return failed ? 1 : 0;
+}
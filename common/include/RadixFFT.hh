@@ -0,0 +1,82 @@
+/*
+ * RadixFFT.hh
+ *
+ * In-place iterative radix-2 FFT shared by the waveform code of CRAB
+ * (Digitiser) and ALICE (WireSignalEngine). Header only, so that every
+ * project only needs this directory on its include path. The two ways
+ * WireSignalEngine convolves arrivals with a response are here as well, so
+ * that common/check/RadixFFTCheck.cc can compare them without Garfield.
+ */
+
+#ifndef RadixFFT_hh
+#define RadixFFT_hh 1
+
+#include <cmath>
+#include <complex>
+#include <utility>
+#include <vector>
+
+namespace radixfft {
+
+    typedef std::complex<double> Complex;
+
+    // Size must be a power of two, the inverse is normalised by 1/n
+    inline void Transform(std::vector<Complex>& a, bool inverse) {
+        const std::size_t n = a.size();
+        const double twopi = 2.*std::acos(-1.);
+
+        // Bit reversal permutation
+        for (std::size_t i = 1, j = 0; i < n; i++){
+            std::size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if (i < j) std::swap(a[i], a[j]);
+        }
+
+        for (std::size_t len = 2; len <= n; len <<= 1){
+            double angle = (inverse ? 1. : -1.)*twopi/len;
+            Complex wlen(std::cos(angle), std::sin(angle));
+            for (std::size_t i = 0; i < n; i += len){
+                Complex w(1.);
+                for (std::size_t k = 0; k < len/2; k++){
+                    Complex u = a[i + k];
+                    Complex v = a[i + k + len/2]*w;
+                    a[i + k] = u + v;
+                    a[i + k + len/2] = u - v;
+                    w *= wlen;
+                }
+            }
+        }
+
+        if (inverse)
+            for (auto& x : a) x /= (double)n;
+    }
+
+    // Smallest power of two not below n
+    inline std::size_t Size(std::size_t n) {
+        std::size_t size = 1;
+        while (size < n) size <<= 1;
+        return size;
+    }
+
+    // Transform of x zero padded to size, a power of two of at least twice
+    // the length of the signals so that the product gives a linear convolution
+    inline std::vector<Complex> Spectrum(const std::vector<double>& x, std::size_t size) {
+        std::vector<Complex> s(size, 0.);
+        for (std::size_t i = 0; i < x.size() && i < size; i++) s[i] = x[i];
+        Transform(s, false);
+        return s;
+    }
+
+    // out[b] += sum over i <= b of a[i]*r[b - i], for the bins of out
+    inline void AddDirectConvolution(const std::vector<double>& a, const std::vector<double>& r,
+                                     std::vector<double>& out) {
+        const std::size_t n = out.size();
+        for (std::size_t i = 0; i < n && i < a.size(); i++) {
+            if (a[i] == 0.) continue;
+            for (std::size_t b = i; b < n && b - i < r.size(); b++) out[b] += a[i]*r[b - i];
+        }
+    }
+}
+
+#endif